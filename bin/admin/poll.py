@@ -0,0 +1,110 @@
+# $Id$
+
+# Connects to the admin port of a running dedicated server and checks that
+# polling the economy and the statistics of the companies honours the delta
+# setting of the company filter.
+#
+# Usage: python3 admin/poll.py port password
+
+import socket
+import struct
+import sys
+import time
+
+ADMIN_PACKET_ADMIN_JOIN = 0
+ADMIN_PACKET_ADMIN_QUIT = 1
+ADMIN_PACKET_ADMIN_POLL = 3
+ADMIN_PACKET_ADMIN_PING = 7
+ADMIN_PACKET_ADMIN_COMPANY_FILTER = 8
+
+ADMIN_PACKET_SERVER_ERROR = 102
+ADMIN_PACKET_SERVER_WELCOME = 104
+ADMIN_PACKET_SERVER_COMPANY_ECONOMY = 117
+ADMIN_PACKET_SERVER_COMPANY_STATS = 118
+ADMIN_PACKET_SERVER_PONG = 126
+ADMIN_PACKET_SERVER_COMPANY_DELTA = 128
+
+ADMIN_UPDATE_COMPANY_ECONOMY = 3
+ADMIN_UPDATE_COMPANY_STATS = 4
+
+
+class Admin:
+	def __init__(self, port):
+		for attempt in range(60):
+			try:
+				self.sock = socket.create_connection(("127.0.0.1", port))
+				break
+			except OSError:
+				time.sleep(0.5)
+		else:
+			raise RuntimeError("cannot connect to the admin port")
+		self.sock.settimeout(30)
+		self.buf = b""
+		self.ping = 0
+
+	def send(self, type, data=b""):
+		self.sock.sendall(struct.pack("<HB", len(data) + 3, type) + data)
+
+	def recv(self):
+		while True:
+			if len(self.buf) >= 2:
+				size = struct.unpack("<H", self.buf[:2])[0]
+				if len(self.buf) >= size:
+					packet = self.buf[:size]
+					self.buf = self.buf[size:]
+					return packet[2], packet[3:]
+			data = self.sock.recv(4096)
+			if not data:
+				raise RuntimeError("connection closed by the server")
+			self.buf += data
+
+	def join(self, password):
+		self.send(ADMIN_PACKET_ADMIN_JOIN, password.encode() + b"\0regression\0" + b"1.0\0")
+		while True:
+			type, data = self.recv()
+			if type == ADMIN_PACKET_SERVER_ERROR:
+				raise RuntimeError("joining failed with error %d" % data[0])
+			if type == ADMIN_PACKET_SERVER_WELCOME:
+				return
+
+	def poll(self, update_type):
+		"""Poll and return the types of the packets the server answers with."""
+		self.ping += 1
+		self.send(ADMIN_PACKET_ADMIN_POLL, struct.pack("<BI", update_type, 0xFFFFFFFF))
+		self.send(ADMIN_PACKET_ADMIN_PING, struct.pack("<I", self.ping))
+		types = []
+		while True:
+			type, data = self.recv()
+			if type == ADMIN_PACKET_SERVER_PONG and struct.unpack("<I", data)[0] == self.ping:
+				return types
+			types.append(type)
+
+
+def check(admin, update_type, full_type, delta):
+	admin.send(ADMIN_PACKET_ADMIN_COMPANY_FILTER, struct.pack("<HHIB", update_type, 0xFFFF, 0xFFFFFFFF, delta))
+	types = admin.poll(update_type)
+
+	expected = ADMIN_PACKET_SERVER_COMPANY_DELTA if delta else full_type
+	name = "%s poll with delta %s" % ("economy" if update_type == ADMIN_UPDATE_COMPANY_ECONOMY else "stats", "on" if delta else "off")
+	if len(types) == 0 or any(type != expected for type in types):
+		print("%s failed: expected packets %d, got %s" % (name, expected, types))
+		return False
+	print("%s passed" % name)
+	return True
+
+
+def main():
+	admin = Admin(int(sys.argv[1]))
+	admin.join(sys.argv[2])
+
+	ok = True
+	for update_type, full_type in ((ADMIN_UPDATE_COMPANY_ECONOMY, ADMIN_PACKET_SERVER_COMPANY_ECONOMY), (ADMIN_UPDATE_COMPANY_STATS, ADMIN_PACKET_SERVER_COMPANY_STATS)):
+		for delta in (True, False):
+			ok = check(admin, update_type, full_type, delta) and ok
+
+	admin.send(ADMIN_PACKET_ADMIN_QUIT)
+	return 0 if ok else 1
+
+
+if __name__ == "__main__":
+	sys.exit(main())
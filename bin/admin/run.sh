@@ -0,0 +1,33 @@
+#!/bin/sh
+
+# $Id$
+
+# Runs the AI regression savegame on a dedicated server and checks the
+# company polls of the admin port with admin/poll.py; skipped when there
+# is no python3.
+#
+# Usage: sh admin/run.sh
+
+if ! [ -f admin/admin.cfg ]; then
+	echo "Make sure you are in the root of OpenTTD before starting this script."
+	exit 1
+fi
+
+if ! command -v python3 > /dev/null 2>&1; then
+	echo "python3 not found, skipping the admin port test"
+	exit 0
+fi
+
+./openttd -D 127.0.0.1 -x -c admin/admin.cfg -g ai/regression/regression.sav > /dev/null 2>&1 < /dev/null &
+server=$!
+
+python3 admin/poll.py 3987 regression
+ret=$?
+
+kill $server
+wait $server 2> /dev/null
+
+echo ""
+echo "Admin port test done"
+
+exit $ret
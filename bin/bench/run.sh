@@ -0,0 +1,46 @@
+#!/bin/sh
+
+# $Id$
+
+# Runs every savegame in bench/ and the AI regression savegame for a fixed
+# number of ticks with the null drivers and reports the timings per phase
+# of the game loop, the number of ticks per second and a checksum of the
+# final state of the game. The checksum must not change between runs of the
+# same binary; if it changes between builds the simulation itself changed.
+# With -R the savegames are instead saved and loaded in memory with every
+# savegame format, reporting the timings per format and per chunk.
+#
+# Usage: sh bench/run.sh [ticks | -R rounds]
+
+if ! [ -f bench/bench.cfg ]; then
+	echo "Make sure you are in the root of OpenTTD before starting this script."
+	exit 1
+fi
+
+mode="-B"
+if [ "$1" = "-R" ]; then
+	mode="-R"
+	shift
+fi
+
+count="$1"
+if [ -z "$count" ]; then
+	if [ "$mode" = "-R" ]; then
+		count=3
+	else
+		count=10000
+	fi
+fi
+
+ret=0
+for savegame in bench/*.sav ai/regression/regression.sav; do
+	if ! [ -f "$savegame" ]; then
+		continue
+	fi
+
+	echo "=== $savegame"
+	./openttd -x -c bench/bench.cfg $mode $count -g "$savegame" || ret=1
+	echo ""
+done
+
+exit $ret
@@ -0,0 +1,59 @@
+#!/bin/sh
+
+# $Id$
+
+# Plays the AI regression savegame with monthly delta autosaves long enough
+# for the autosaves to rotate through their slots a few times, and then
+# loads every autosave and every base of the delta autosaves that is left.
+# All of them have to load. The autosaves are written to a personal
+# directory of their own, so the base graphics have to be in the baseset
+# directory of the working directory or of the installation.
+#
+# Usage: sh saveload/run.sh
+
+if ! [ -f saveload/autosave.cfg ]; then
+	echo "Make sure you are in the root of OpenTTD before starting this script."
+	exit 1
+fi
+
+home="`pwd`/saveload/home"
+autosave_dir="$home/.openttd/save/autosave"
+rm -rf "$home"
+mkdir -p "$autosave_dir"
+
+# Six monthly autosaves into 3 slots with a new base every 2 autosaves, so
+# the slots rotate twice and a base has been replaced while deltas against
+# it were still in the rotation.
+HOME="$home" XDG_DATA_HOME="$home" ./openttd -x -c saveload/autosave.cfg -snull -mnull -vnull:ticks=27500 -g ai/regression/regression.sav > /dev/null 2>&1
+
+ret=0
+count=0
+for savegame in "$autosave_dir"/*.sav; do
+	if ! [ -f "$savegame" ]; then
+		continue
+	fi
+	count=`expr $count + 1`
+
+	# Check the savegame like the load dialog does, then load it; a failed load nulls the pointers.
+	res="`HOME="$home" XDG_DATA_HOME="$home" ./openttd -x -c saveload/autosave.cfg -q "$savegame" 2>&1`" &&
+			res="`HOME="$home" XDG_DATA_HOME="$home" ./openttd -x -c saveload/autosave.cfg -snull -mnull -vnull:ticks=1 -g "$savegame" -d sl=1 2>&1`"
+	if [ $? -eq 0 ] && echo "$res" | grep -q "Loading savegame version" && ! echo "$res" | grep -q "Nulling pointers"; then
+		echo "Loading `basename $savegame` passed"
+	else
+		echo "Loading `basename $savegame` failed:"
+		echo "$res" | grep -v '^dbg: \[sl\] '
+		ret=1
+	fi
+done
+
+if [ $count -lt 5 ]; then
+	echo "Expected 3 autosaves and 2 bases, found $count savegames"
+	ret=1
+fi
+
+echo ""
+echo "Autosave test done"
+
+rm -rf "$home"
+
+exit $ret
@@ -203,10 +203,11 @@ bool StationCargoReroute::operator()(CargoPacket *cp)
 		this->destination->AddToCache(cp_new);
 	}
 
-	/* Legal, as insert doesn't invalidate iterators in the MultiMap, however
-	 * this might insert the packet between range.first and range.second (which might be end())
-	 * This is why we check for GetKey above to avoid infinite loops. */
-	this->destination->packets.Insert(next, cp_new);
+	/* Legal, as the packet is added to the bucket of another next hop than
+	 * the one StationCargoList::ShiftCargo is working on. */
+	StationCargoBucket &bucket = this->destination->packets[next];
+	bucket.push_back(cp_new);
+	bucket.amount += cp_new->Count();
 	return cp_new == cp;
 }
 
@@ -224,10 +225,12 @@ bool VehicleCargoReroute::operator()(CargoPacket *cp)
 	}
 	if (this->source != this->destination) {
 		this->source->RemoveFromMeta(cp_new, VehicleCargoList::MTA_TRANSFER, cp_new->Count());
+		this->destination->StartAging(cp_new);
 		this->destination->AddToMeta(cp_new, VehicleCargoList::MTA_TRANSFER);
 	}
 
-	/* Legal, as front pushing doesn't invalidate iterators in std::list. */
+	/* Legal, as VehicleCargoList::ShiftCargo keeps track of the packets
+	 * being prepended to the list it works on. */
 	this->destination->packets.push_front(cp_new);
 	return cp_new == cp;
 }
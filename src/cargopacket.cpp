@@ -26,6 +26,7 @@ INSTANTIATE_POOL_METHODS(CargoPacket)
  */
 CargoPacket::CargoPacket()
 {
+	this->age_epoch   = 0;
 	this->source_type = ST_INDUSTRY;
 	this->source_id   = INVALID_SOURCE;
 }
@@ -42,9 +43,10 @@ CargoPacket::CargoPacket()
  * that, in contrary to all other pools, does not memset to 0.
  */
 CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16 count, SourceType source_type, SourceID source_id) :
-	feeder_share(0),
 	count(count),
 	days_in_transit(0),
+	age_epoch(0),
+	feeder_share(0),
 	source_id(source_id),
 	source(source),
 	source_xy(source_xy),
@@ -69,9 +71,10 @@ CargoPacket::CargoPacket(StationID source, TileIndex source_xy, uint16 count, So
  * that, in contrary to all other pools, does not memset to 0.
  */
 CargoPacket::CargoPacket(uint16 count, byte days_in_transit, StationID source, TileIndex source_xy, TileIndex loaded_at_xy, Money feeder_share, SourceType source_type, SourceID source_id) :
-		feeder_share(feeder_share),
 		count(count),
 		days_in_transit(days_in_transit),
+		age_epoch(0),
+		feeder_share(feeder_share),
 		source_id(source_id),
 		source(source),
 		source_xy(source_xy),
@@ -92,6 +95,7 @@ CargoPacket *CargoPacket::Split(uint new_size)
 
 	Money fs = this->FeederShare(new_size);
 	CargoPacket *cp_new = new CargoPacket(new_size, this->days_in_transit, this->source, this->source_xy, this->loaded_at_xy, fs, this->source_type, this->source_id);
+	cp_new->age_epoch = this->age_epoch;
 	this->feeder_share -= fs;
 	this->count -= new_size;
 	return cp_new;
@@ -254,6 +258,7 @@ void VehicleCargoList::Append(CargoPacket *cp, MoveToAction action)
 	assert(cp != NULL);
 	assert(action == MTA_LOAD ||
 			(action == MTA_KEEP && this->action_counts[MTA_LOAD] == 0));
+	this->StartAging(cp);
 	this->AddToMeta(cp, action);
 
 	if (this->count == cp->count) {
@@ -264,6 +269,7 @@ void VehicleCargoList::Append(CargoPacket *cp, MoveToAction action)
 	uint sum = cp->count;
 	for (ReverseIterator it(this->packets.rbegin()); it != this->packets.rend(); it++) {
 		CargoPacket *icp = *it;
+		this->ApplyAging(icp);
 		if (VehicleCargoList::TryMerge(icp, cp)) return;
 		sum += icp->count;
 		if (sum >= this->action_counts[action]) {
@@ -286,11 +292,16 @@ void VehicleCargoList::Append(CargoPacket *cp, MoveToAction action)
 template<class Taction>
 void VehicleCargoList::ShiftCargo(Taction action)
 {
-	Iterator it(this->packets.begin());
-	while (it != this->packets.end() && action.MaxMove() > 0) {
-		CargoPacket *cp = *it;
+	/* The action may prepend (parts of) packets to this very list, so keep
+	 * track of the position of the packet by index instead of by iterator. */
+	uint pos = 0;
+	while (pos < this->packets.size() && action.MaxMove() > 0) {
+		CargoPacket *cp = this->packets[pos];
+		this->ApplyAging(cp);
+		uint size = (uint)this->packets.size();
 		if (action(cp)) {
-			it = this->packets.erase(it);
+			pos += (uint)this->packets.size() - size;
+			this->packets.erase(this->packets.begin() + pos);
 		} else {
 			break;
 		}
@@ -308,18 +319,11 @@ void VehicleCargoList::ShiftCargo(Taction action)
 template<class Taction>
 void VehicleCargoList::PopCargo(Taction action)
 {
-	if (this->packets.empty()) return;
-	Iterator it(--(this->packets.end()));
-	Iterator begin(this->packets.begin());
-	while (action.MaxMove() > 0) {
-		CargoPacket *cp = *it;
+	while (!this->packets.empty() && action.MaxMove() > 0) {
+		CargoPacket *cp = this->packets.back();
+		this->ApplyAging(cp);
 		if (action(cp)) {
-			if (it != begin) {
-				this->packets.erase(it--);
-			} else {
-				this->packets.erase(it);
-				break;
-			}
+			this->packets.pop_back();
 		} else {
 			break;
 		}
@@ -377,17 +381,45 @@ void VehicleCargoList::AddToMeta(const CargoPacket *cp, MoveToAction action)
 }
 
 /**
- * Ages the all cargo in this list.
+ * Ages the all cargo in this list. As long as no packet can be at the maximum
+ * age, this only advances the epoch of the list; the packets catch up when
+ * they are paid for or leave the list.
  */
 void VehicleCargoList::AgeCargo()
 {
+	if (this->packets.empty()) {
+		this->max_days_in_transit = 0;
+		return;
+	}
+
+	if (this->max_days_in_transit < 0xFF) {
+		this->age_epoch++;
+		this->max_days_in_transit++;
+		this->cargo_days_in_transit += this->count;
+		return;
+	}
+
+	this->max_days_in_transit = 0;
 	for (ConstIterator it(this->packets.begin()); it != this->packets.end(); it++) {
 		CargoPacket *cp = *it;
+		this->ApplyAging(cp);
 		/* If we're at the maximum, then we can't increase no more. */
-		if (cp->days_in_transit == 0xFF) continue;
+		if (cp->days_in_transit != 0xFF) {
+			cp->days_in_transit++;
+			this->cargo_days_in_transit += cp->count;
+		}
+		this->max_days_in_transit = max(this->max_days_in_transit, cp->days_in_transit);
+	}
+}
 
-		cp->days_in_transit++;
-		this->cargo_days_in_transit += cp->count;
+/**
+ * Apply the pending aging to all packets in this list, so that their days in
+ * transit are up to date, e.g. for saving them.
+ */
+void VehicleCargoList::ApplyAging()
+{
+	for (ConstIterator it(this->packets.begin()); it != this->packets.end(); it++) {
+		this->ApplyAging(*it);
 	}
 }
 
@@ -449,18 +481,21 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 	this->AssertCountConsistency();
 	assert(this->action_counts[MTA_LOAD] == 0);
 	this->action_counts[MTA_TRANSFER] = this->action_counts[MTA_DELIVER] = this->action_counts[MTA_KEEP] = 0;
-	Iterator deliver = this->packets.end();
-	Iterator it = this->packets.begin();
-	uint sum = 0;
+
+	/* Rebuild the list: packets to transfer are prepended, packets to deliver
+	 * appended and packets to keep are appended after those. */
+	CargoPacketList packets;
+	CargoPacketList keep;
+	packets.swap(this->packets);
 
 	bool force_keep = (order_flags & OUFB_NO_UNLOAD) != 0;
 	bool force_unload = (order_flags & OUFB_UNLOAD) != 0;
 	bool force_transfer = (order_flags & (OUFB_TRANSFER | OUFB_UNLOAD)) != 0;
-	assert(this->count > 0 || it == this->packets.end());
-	while (sum < this->count) {
+	assert(this->count > 0 || packets.empty());
+	for (Iterator it(packets.begin()); it != packets.end(); ++it) {
 		CargoPacket *cp = *it;
+		this->ApplyAging(cp);
 
-		this->packets.erase(it++);
 		StationID cargo_next = INVALID_STATION;
 		MoveToAction action = MTA_LOAD;
 		if (force_keep) {
@@ -511,11 +546,10 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 		Money share;
 		switch (action) {
 			case MTA_KEEP:
-				this->packets.push_back(cp);
-				if (deliver == this->packets.end()) --deliver;
+				keep.push_back(cp);
 				break;
 			case MTA_DELIVER:
-				this->packets.insert(deliver, cp);
+				this->packets.push_back(cp);
 				break;
 			case MTA_TRANSFER:
 				this->packets.push_front(cp);
@@ -529,8 +563,8 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 				NOT_REACHED();
 		}
 		this->action_counts[action] += cp->count;
-		sum += cp->count;
 	}
+	for (Iterator it(keep.begin()); it != keep.end(); ++it) this->packets.push_back(*it);
 	this->AssertCountConsistency();
 	return this->action_counts[MTA_DELIVER] > 0 || this->action_counts[MTA_TRANSFER] > 0;
 }
@@ -538,6 +572,12 @@ bool VehicleCargoList::Stage(bool accepted, StationID current_station, StationID
 /** Invalidates the cached data and rebuild it. */
 void VehicleCargoList::InvalidateCache()
 {
+	for (ConstIterator it(this->packets.begin()); it != this->packets.end(); it++) {
+		CargoPacket *cp = *it;
+		this->ApplyAging(cp);
+		this->max_days_in_transit = max(this->max_days_in_transit, cp->days_in_transit);
+	}
+
 	this->feeder_share = 0;
 	this->Parent::InvalidateCache();
 }
@@ -578,14 +618,14 @@ uint VehicleCargoList::Reassign<VehicleCargoList::MTA_DELIVER, VehicleCargoList:
 	max_move = min(this->action_counts[MTA_DELIVER], max_move);
 
 	uint sum = 0;
-	for (Iterator it(this->packets.begin()); sum < this->action_counts[MTA_TRANSFER] + max_move;) {
-		CargoPacket *cp = *it++;
+	for (uint pos = 0; sum < this->action_counts[MTA_TRANSFER] + max_move;) {
+		CargoPacket *cp = this->packets[pos++];
 		sum += cp->Count();
 		if (sum <= this->action_counts[MTA_TRANSFER]) continue;
 		if (sum > this->action_counts[MTA_TRANSFER] + max_move) {
 			CargoPacket *cp_split = cp->Split(sum - this->action_counts[MTA_TRANSFER] + max_move);
 			sum -= cp_split->Count();
-			this->packets.insert(it, cp_split);
+			this->packets.insert(this->packets.begin() + pos++, cp_split);
 		}
 		cp->next_station = next_station;
 	}
@@ -693,14 +733,28 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 	assert(cp != NULL);
 	this->AddToCache(cp);
 
-	StationCargoPacketMap::List &list = this->packets[next];
-	for (StationCargoPacketMap::List::reverse_iterator it(list.rbegin());
-			it != list.rend(); it++) {
+	StationCargoBucket &bucket = this->packets[next];
+	bucket.amount += cp->count;
+	for (StationCargoBucket::reverse_iterator it(bucket.rbegin()); it != bucket.rend(); it++) {
 		if (StationCargoList::TryMerge(*it, cp)) return;
 	}
 
 	/* The packet could not be merged with another one */
-	list.push_back(cp);
+	bucket.push_back(cp);
+}
+
+/** Invalidates the cached data and rebuilds it, including the amounts per next hop. */
+void StationCargoList::InvalidateCache()
+{
+	this->Parent::InvalidateCache();
+
+	for (StationCargoPacketMap::MapIterator it(this->packets.begin()); it != this->packets.end(); ++it) {
+		StationCargoBucket &bucket = it->second;
+		bucket.amount = 0;
+		for (StationCargoBucket::const_iterator cp(bucket.begin()); cp != bucket.end(); ++cp) {
+			bucket.amount += (*cp)->count;
+		}
+	}
 }
 
 /**
@@ -718,16 +772,27 @@ void StationCargoList::Append(CargoPacket *cp, StationID next)
 template <class Taction>
 bool StationCargoList::ShiftCargo(Taction &action, StationID next)
 {
-	std::pair<Iterator, Iterator> range(this->packets.equal_range(next));
-	for (Iterator it(range.first); it != range.second && it.GetKey() == next;) {
+	StationCargoPacketMap::MapIterator it(this->packets.find(next));
+	if (it == this->packets.end()) return true;
+
+	/* Actions only ever add packets to the buckets of other next hops, which
+	 * leaves this bucket and the reference to it alone. */
+	StationCargoBucket &bucket = it->second;
+	do {
 		if (action.MaxMove() == 0) return false;
-		CargoPacket *cp = *it;
+		CargoPacket *cp = bucket.front();
+		uint count = cp->count;
 		if (action(cp)) {
-			it = this->packets.erase(it);
+			bucket.amount -= count;
+			bucket.pop_front();
 		} else {
+			/* The action may have taken a part of the packet. */
+			bucket.amount -= count - cp->count;
 			return false;
 		}
-	}
+	} while (!bucket.empty());
+
+	this->packets.Map::erase(it);
 	return true;
 }
 
@@ -788,6 +853,7 @@ uint StationCargoList::Truncate(uint max_move, StationCargoAmountMap *cargo_per_
 			if (cp->count > diff) {
 				if (diff > 0) {
 					this->RemoveFromCache(cp, diff);
+					it.GetMapIter()->second.amount -= diff;
 					cp->Reduce(diff);
 					moved += diff;
 				}
@@ -799,6 +865,7 @@ uint StationCargoList::Truncate(uint max_move, StationCargoAmountMap *cargo_per_
 					++it;
 				}
 			} else {
+				it.GetMapIter()->second.amount -= cp->count;
 				it = this->packets.erase(it);
 				if (do_count && loop > 0) {
 					(*cargo_per_source)[cp->source] -= cp->count;
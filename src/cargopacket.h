@@ -19,14 +19,14 @@
 #include "cargo_type.h"
 #include "vehicle_type.h"
 #include "core/multimap.hpp"
-#include <list>
+#include "core/smalldeque_type.hpp"
 
 /** Unique identifier for a single cargo packet. */
 typedef uint32 CargoPacketID;
 struct CargoPacket;
 
 /** Type of the pool for cargo packets for a little over 16 million packets. */
-typedef Pool<CargoPacket, CargoPacketID, 1024, 0xFFF000, PT_NORMAL, true, false> CargoPacketPool;
+typedef Pool<CargoPacket, CargoPacketID, 1024, 0xFFF000, PT_NORMAL, true, false, true> CargoPacketPool;
 /** The actual pool with cargo packets. */
 extern CargoPacketPool _cargopacket_pool;
 
@@ -43,9 +43,10 @@ typedef uint32 TileOrStationID;
  */
 struct CargoPacket : CargoPacketPool::PoolItem<&_cargopacket_pool> {
 private:
-	Money feeder_share;         ///< Value of feeder pickup to be paid for on delivery of cargo.
 	uint16 count;               ///< The amount of cargo in this packet.
 	byte days_in_transit;       ///< Amount of days this packet has been in transit.
+	byte age_epoch;             ///< Aging epoch of the vehicle cargo list up to which #days_in_transit is up to date.
+	Money feeder_share;         ///< Value of feeder pickup to be paid for on delivery of cargo.
 	SourceTypeByte source_type; ///< Type of \c source_id.
 	SourceID source_id;         ///< Index of source, INVALID_SOURCE if unknown/invalid.
 	StationID source;           ///< The station where the cargo came from first.
@@ -128,6 +129,7 @@ public:
 	 * Gets the number of days this cargo has been in transit.
 	 * This number isn't really in days, but in 2.5 days (CARGO_AGING_TICKS = 185 ticks) and
 	 * it is capped at 255.
+	 * @note For packets in a vehicle this excludes the aging the VehicleCargoList did not apply yet.
 	 * @return Length this cargo has been in transit.
 	 */
 	inline byte DaysInTransit() const
@@ -275,7 +277,7 @@ public:
 	void InvalidateCache();
 };
 
-typedef std::list<CargoPacket *> CargoPacketList;
+typedef SmallDeque<CargoPacket *> CargoPacketList;
 
 /**
  * CargoList that is used for vehicles.
@@ -287,6 +289,8 @@ protected:
 
 	Money feeder_share;                     ///< Cache for the feeder share.
 	uint action_counts[NUM_MOVE_TO_ACTION]; ///< Counts of cargo to be transfered, delivered, kept and loaded.
+	byte age_epoch;                         ///< Number of times the cargo has been aged, wrapping around.
+	byte max_days_in_transit;               ///< Upper bound for the days in transit of the packets.
 
 	template<class Taction>
 	void ShiftCargo(Taction action);
@@ -305,6 +309,26 @@ protected:
 				this->action_counts[MTA_LOAD] == this->count);
 	}
 
+	/**
+	 * Apply the aging the packet missed while it was in this list.
+	 * @param cp Packet in this list.
+	 */
+	inline void ApplyAging(CargoPacket *cp) const
+	{
+		cp->days_in_transit += (byte)(this->age_epoch - cp->age_epoch);
+		cp->age_epoch = this->age_epoch;
+	}
+
+	/**
+	 * Let a packet that enters this list take part in its aging.
+	 * @param cp Packet with up to date days in transit.
+	 */
+	inline void StartAging(CargoPacket *cp)
+	{
+		cp->age_epoch = this->age_epoch;
+		this->max_days_in_transit = max(this->max_days_in_transit, cp->days_in_transit);
+	}
+
 	void AddToCache(const CargoPacket *cp);
 	void RemoveFromCache(const CargoPacket *cp, uint count);
 
@@ -408,6 +432,8 @@ public:
 
 	void AgeCargo();
 
+	void ApplyAging();
+
 	void InvalidateCache();
 
 	void SetTransferLoadPlace(TileIndex xy);
@@ -454,7 +480,27 @@ public:
 	}
 };
 
-typedef MultiMap<StationID, CargoPacket *> StationCargoPacketMap;
+/**
+ * The packets of a station cargo list that have the same next hop, together
+ * with the amount of cargo in them.
+ */
+struct StationCargoBucket : CargoPacketList {
+	uint amount; ///< Sum of the counts of the packets.
+
+	StationCargoBucket() : amount(0) {}
+
+	/**
+	 * Swap the packets and the amount of two buckets.
+	 * @param other The bucket to swap with.
+	 */
+	void swap(StationCargoBucket &other)
+	{
+		this->CargoPacketList::swap(other);
+		Swap(this->amount, other.amount);
+	}
+};
+
+typedef MultiMap<StationID, CargoPacket *, std::less<StationID>, StationCargoBucket> StationCargoPacketMap;
 typedef std::map<StationID, uint> StationCargoAmountMap;
 
 /**
@@ -491,6 +537,8 @@ public:
 
 	void Append(CargoPacket *cp, StationID next);
 
+	void InvalidateCache();
+
 	/**
 	 * Check for cargo headed for a specific station.
 	 * @param next Station the cargo is headed for.
@@ -524,6 +572,18 @@ public:
 		return this->count;
 	}
 
+	/**
+	 * Returns the amount of cargo still available for loading that has the
+	 * given station as next hop.
+	 * @param next Station the cargo is headed for.
+	 * @return Cargo waiting for that station.
+	 */
+	inline uint AvailableViaCount(StationID next) const
+	{
+		StationCargoPacketMap::ConstMapIterator it = this->packets.find(next);
+		return it == this->packets.end() ? 0 : it->second.amount;
+	}
+
 	/**
 	 * Returns sum of cargo reserved for loading onto vehicles.
 	 * @return Cargo reserved for loading.
@@ -38,6 +38,9 @@
 #include "console_func.h"
 #include "engine_base.h"
 #include "game/game.hpp"
+#include "tick_profiler.h"
+#include "economy_func.h"
+#include "vehicle_func.h"
 #include "table/strings.h"
 
 /* scriptfile handling */
@@ -683,6 +686,32 @@ DEF_CONSOLE_CMD(ConServerInfo)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConNetworkSendStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show how efficiently packets are sent over the TCP connections. Usage 'net_send_stats [reset]'");
+		return true;
+	}
+
+	if (argc > 2 || (argc == 2 && strcasecmp(argv[1], "reset") != 0)) return false;
+
+	NetworkTCPSendStats &stats = _network_tcp_send_stats;
+	if (argc == 2) {
+		MemSetT(&stats, 0);
+		IConsolePrint(CC_DEFAULT, "Send statistics reset.");
+		return true;
+	}
+
+	IConsolePrintF(CC_DEFAULT, "Frames:                " OTTD_PRINTF64, stats.frames);
+	IConsolePrintF(CC_DEFAULT, "Send calls:            " OTTD_PRINTF64, stats.calls);
+	IConsolePrintF(CC_DEFAULT, "Bytes sent:            " OTTD_PRINTF64, stats.bytes);
+	IConsolePrintF(CC_DEFAULT, "Packets sent:          " OTTD_PRINTF64, stats.packets);
+	IConsolePrintF(CC_DEFAULT, "Send calls per frame:  %.2f", stats.frames == 0 ? 0.0 : (double)stats.calls / stats.frames);
+	IConsolePrintF(CC_DEFAULT, "Bytes per send call:   %.1f", stats.calls == 0 ? 0.0 : (double)stats.bytes / stats.calls);
+	IConsolePrintF(CC_DEFAULT, "Packets per send call: %.2f", stats.calls == 0 ? 0.0 : (double)stats.packets / stats.calls);
+	return true;
+}
+
 DEF_CONSOLE_CMD(ConClientNickChange)
 {
 	if (argc != 3) {
@@ -1325,6 +1354,113 @@ DEF_CONSOLE_CMD(ConGetDate)
 	return true;
 }
 
+DEF_CONSOLE_CMD(ConTickProfile)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show how long each phase of the game loop took over the last ticks. Usage: 'tick_profile [histogram|reset]'");
+		IConsoleHelp("All durations are in microseconds; the average is taken since the last reset.");
+		return true;
+	}
+
+	if (argc > 2) return false;
+
+	if (argc == 2 && strcasecmp(argv[1], "reset") == 0) {
+		ResetTickProfiler();
+		IConsolePrint(CC_DEFAULT, "Tick profile reset.");
+		return true;
+	}
+
+	if (argc == 2 && strcasecmp(argv[1], "histogram") == 0) {
+		char buf[128];
+		char *p = buf;
+		for (uint i = 0; i < TICK_HISTOGRAM_BUCKETS - 1; i++) {
+			p += seprintf(p, lastof(buf), " <%6u", GetTickHistogramBucketLimit(i));
+		}
+		IConsolePrintF(CC_DEFAULT, "%-15s%s  longer", "phase", buf);
+
+		for (uint i = 0; i < TP_END; i++) {
+			uint16 buckets[TICK_HISTOGRAM_BUCKETS];
+			_tick_profile[i].GetHistogram(buckets);
+
+			p = buf;
+			for (uint j = 0; j < TICK_HISTOGRAM_BUCKETS; j++) {
+				p += seprintf(p, lastof(buf), " %7u", buckets[j]);
+			}
+			IConsolePrintF(CC_DEFAULT, "%-15s%s", GetTickPhaseName((TickPhase)i), buf);
+		}
+		return true;
+	}
+
+	if (argc == 2) return false;
+
+	IConsolePrintF(CC_DEFAULT, "%-15s %8s %8s %8s %8s %8s", "phase", "avg", "p50", "p95", "p99", "max");
+	for (uint i = 0; i < TP_END; i++) {
+		const TickPhaseHistory &h = _tick_profile[i];
+		IConsolePrintF(CC_DEFAULT, "%-15s %8u %8u %8u %8u %8u", GetTickPhaseName((TickPhase)i),
+				h.GetAverage(), h.GetPercentile(50), h.GetPercentile(95), h.GetPercentile(99), h.GetPercentile(100));
+	}
+	IConsolePrintF(CC_DEFAULT, "Stations with loading vehicles in the last tick: %u", _loading_stations_last_tick);
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConVehicleHash)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show the occupancy of the buckets of the tile hash of the vehicles. Usage: 'vehicle_hash'");
+		return true;
+	}
+
+	if (argc != 1) return false;
+
+	VehicleTileHashStats stats;
+	GetVehicleTileHashStats(&stats);
+
+	uint buckets = 1 << (stats.bits_x + stats.bits_y);
+	IConsolePrintF(CC_DEFAULT, "Buckets:  %u x %u", 1 << stats.bits_x, 1 << stats.bits_y);
+	IConsolePrintF(CC_DEFAULT, "Vehicles: %u", stats.vehicles);
+	IConsolePrintF(CC_DEFAULT, "Used:     %u (%u%%)", stats.used, stats.used * 100 / buckets);
+	IConsolePrintF(CC_DEFAULT, "Average:  %u.%02u vehicles per used bucket", stats.used == 0 ? 0 : stats.vehicles / stats.used, stats.used == 0 ? 0 : stats.vehicles * 100 / stats.used % 100);
+	IConsolePrintF(CC_DEFAULT, "Longest:  %u", stats.longest);
+	for (uint i = 0; i < lengthof(stats.lengths); i++) {
+		IConsolePrintF(CC_DEFAULT, "  %s%u vehicles: %u buckets", i == lengthof(stats.lengths) - 1 ? ">=" : "", i, stats.lengths[i]);
+	}
+	return true;
+}
+
+DEF_CONSOLE_CMD(ConPoolStats)
+{
+	if (argc == 0) {
+		IConsoleHelp("Show the occupancy of all pools. Usage: 'pool_stats'");
+		IConsoleHelp("'used' is the range of indexes in use, 'frag' the part of that range that is free.");
+		IConsoleHelp("The allocation rate is measured since the previous invocation of this command.");
+		return true;
+	}
+
+	if (argc != 1) return false;
+
+	/* Allocation counts and time of the previous invocation, to determine the rate. */
+	static SmallVector<uint64, 32> last_allocations;
+	static uint32 last_tick = 0;
+	uint32 elapsed = max<uint32>(_realtime_tick - last_tick, 1);
+	last_tick = _realtime_tick;
+
+	IConsolePrintF(CC_DEFAULT, "%-20s %9s %9s %9s %9s %5s %10s", "pool", "items", "used", "capacity", "max", "frag", "allocs/s");
+
+	const PoolVector *pools = PoolBase::GetPools();
+	for (uint i = 0; i < pools->Length(); i++) {
+		PoolStats stats;
+		(*pools)[i]->GetStats(&stats);
+
+		if (i >= last_allocations.Length()) *last_allocations.Append() = 0;
+		uint64 rate = (stats.allocations - last_allocations[i]) * 1000 / elapsed;
+		last_allocations[i] = stats.allocations;
+
+		uint frag = stats.first_unused == 0 ? 0 : (uint)((stats.first_unused - stats.items) * 100 / stats.first_unused);
+		IConsolePrintF(CC_DEFAULT, "%-20s %9u %9u %9u %9u %4u%% %10u", stats.name, (uint)stats.items, (uint)stats.first_unused, (uint)stats.size, (uint)stats.max_size, frag, (uint)rate);
+	}
+	return true;
+}
+
 
 DEF_CONSOLE_CMD(ConAlias)
 {
@@ -1913,6 +2049,9 @@ void IConsoleStdLibRegister()
 	IConsoleCmdRegister("restart",      ConRestart);
 	IConsoleCmdRegister("getseed",      ConGetSeed);
 	IConsoleCmdRegister("getdate",      ConGetDate);
+	IConsoleCmdRegister("tick_profile", ConTickProfile);
+	IConsoleCmdRegister("vehicle_hash", ConVehicleHash);
+	IConsoleCmdRegister("pool_stats", ConPoolStats);
 	IConsoleCmdRegister("quit",         ConExit);
 	IConsoleCmdRegister("resetengines", ConResetEngines, ConHookNoNetwork);
 	IConsoleCmdRegister("reset_enginepool", ConResetEnginePool, ConHookNoNetwork);
@@ -1976,6 +2115,7 @@ void IConsoleStdLibRegister()
 	IConsoleCmdRegister("status",          ConStatus, ConHookServerOnly);
 	IConsoleCmdRegister("server_info",     ConServerInfo, ConHookServerOnly);
 	IConsoleAliasRegister("info",          "server_info");
+	IConsoleCmdRegister("net_send_stats",  ConNetworkSendStats, ConHookNeedNetwork);
 	IConsoleCmdRegister("reconnect",       ConNetworkReconnect, ConHookClientOnly);
 	IConsoleCmdRegister("rcon",            ConRcon, ConHookNeedNetwork);
 
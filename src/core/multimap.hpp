@@ -15,7 +15,7 @@
 #include <map>
 #include <list>
 
-template<typename Tkey, typename Tvalue, typename Tcompare>
+template<typename Tkey, typename Tvalue, typename Tcompare, typename Tlist>
 class MultiMap;
 
 /**
@@ -29,7 +29,7 @@ class MultiMap;
 template<class Tmap_iter, class Tlist_iter, class Tkey, class Tvalue, class Tcompare>
 class MultiMapIterator {
 protected:
-	friend class MultiMap<Tkey, Tvalue, Tcompare>;
+	template<typename, typename, typename, typename> friend class MultiMap;
 	typedef MultiMapIterator<Tmap_iter, Tlist_iter, Tkey, Tvalue, Tcompare> Self;
 
 	Tlist_iter list_iter; ///< Iterator pointing to current position in the current list of items with equal keys.
@@ -50,7 +50,7 @@ public:
 	/**
 	 * Simple, dangerous constructor to allow later assignment with operator=.
 	 */
-	MultiMapIterator() : list_valid(false) {}
+	MultiMapIterator() : list_iter(), list_valid(false) {}
 
 	/**
 	 * Constructor to allow possibly const iterators to be assigned from possibly
@@ -59,7 +59,7 @@ public:
 	 * @param mi One such iterator.
 	 */
 	template<class Tnon_const>
-	MultiMapIterator(Tnon_const mi) : map_iter(mi), list_valid(false) {}
+	MultiMapIterator(Tnon_const mi) : list_iter(), map_iter(mi), list_valid(false) {}
 
 	/**
 	 * Constructor to allow specifying an exact position in map and list. You cannot
@@ -96,8 +96,8 @@ public:
 	{
 		assert(!this->map_iter->second.empty());
 		return this->list_valid ?
-				this->list_iter.operator*() :
-				this->map_iter->second.begin().operator*();
+				*this->list_iter :
+				*this->map_iter->second.begin();
 	}
 
 	/**
@@ -108,8 +108,8 @@ public:
 	{
 		assert(!this->map_iter->second.empty());
 		return this->list_valid ?
-				this->list_iter.operator->() :
-				this->map_iter->second.begin().operator->();
+				&*this->list_iter :
+				&*this->map_iter->second.begin();
 	}
 
 	inline const Tmap_iter &GetMapIter() const { return this->map_iter; }
@@ -133,7 +133,8 @@ public:
 				this->list_valid = false;
 			}
 		} else {
-			this->list_iter = ++(this->map_iter->second.begin());
+			this->list_iter = this->map_iter->second.begin();
+			++this->list_iter;
 			if (this->list_iter == this->map_iter->second.end()) {
 				++this->map_iter;
 			} else {
@@ -281,11 +282,14 @@ bool operator!=(const Tmap_iter2 &iter2, const MultiMapIterator<Tmap_iter1, Tlis
  * internally ordered in a deterministic way (contrary to STL multimap). All
  * STL-compatible members are named in STL style, all others are named in OpenTTD
  * style.
+ * @tparam Tlist Container for the items with equal keys. It needs to provide
+ *               the std::list interface for adding, erasing and iterating, but
+ *               its iterators may be invalidated by erasing.
  */
-template<typename Tkey, typename Tvalue, typename Tcompare = std::less<Tkey> >
-class MultiMap : public std::map<Tkey, std::list<Tvalue>, Tcompare > {
+template<typename Tkey, typename Tvalue, typename Tcompare = std::less<Tkey>, typename Tlist = std::list<Tvalue> >
+class MultiMap : public std::map<Tkey, Tlist, Tcompare > {
 public:
-	typedef typename std::list<Tvalue> List;
+	typedef Tlist List;
 	typedef typename List::iterator ListIterator;
 	typedef typename List::const_iterator ConstListIterator;
 
@@ -13,6 +13,8 @@
 #define POOL_FUNC_HPP
 
 #include "alloc_func.hpp"
+#include "bitmath_func.hpp"
+#include "math_func.hpp"
 #include "mem_func.hpp"
 #include "pool_type.hpp"
 
@@ -21,8 +23,8 @@
  * @param type The return type of the method.
  */
 #define DEFINE_POOL_METHOD(type) \
-	template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type, bool Tcache, bool Tzero> \
-	type Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero>
+	template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type, bool Tcache, bool Tzero, bool Tfree_bitmap> \
+	type Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero, Tfree_bitmap>
 
 /**
  * Create a clean pool.
@@ -35,12 +37,15 @@ DEFINE_POOL_METHOD(inline)::Pool(const char *name) :
 		first_free(0),
 		first_unused(0),
 		items(0),
+		allocations(0),
 #ifdef OTTD_ASSERT
 		checked(0),
 #endif /* OTTD_ASSERT */
 		cleaning(false),
 		data(NULL),
-		alloc_cache(NULL)
+		alloc_cache(NULL),
+		free_bits(NULL),
+		free_words(NULL)
 { }
 
 /**
@@ -59,6 +64,20 @@ DEFINE_POOL_METHOD(inline void)::ResizeFor(size_t index)
 	this->data = ReallocT(this->data, new_size);
 	MemSetT(this->data + this->size, 0, new_size - this->size);
 
+	if (Tfree_bitmap) {
+		size_t old_bits = CeilDiv(this->size, 32);
+		size_t new_bits = CeilDiv(new_size, 32);
+		size_t old_words = CeilDiv(old_bits, 32);
+		size_t new_words = CeilDiv(new_bits, 32);
+
+		this->free_bits = ReallocT(this->free_bits, new_bits);
+		MemSetT(this->free_bits + old_bits, 0, new_bits - old_bits);
+		this->free_words = ReallocT(this->free_words, new_words);
+		MemSetT(this->free_words + old_words, 0, new_words - old_words);
+
+		for (size_t i = this->size; i < new_size; i++) this->MarkFree(i);
+	}
+
 	this->size = new_size;
 }
 
@@ -70,8 +89,20 @@ DEFINE_POOL_METHOD(inline size_t)::FindFirstFree()
 {
 	size_t index = this->first_free;
 
-	for (; index < this->first_unused; index++) {
-		if (this->data[index] == NULL) return index;
+	if (Tfree_bitmap) {
+		/* No index below first_free is free, so the first set bit is the first free index. */
+		size_t words = CeilDiv(CeilDiv(this->size, 32), 32);
+		for (size_t word = index / (32 * 32); word < words; word++) {
+			if (this->free_words[word] == 0) continue;
+
+			size_t bits = word * 32 + FindFirstBit(this->free_words[word]);
+			return bits * 32 + FindFirstBit(this->free_bits[bits]);
+		}
+		index = this->size;
+	} else {
+		for (; index < this->first_unused; index++) {
+			if (this->data[index] == NULL) return index;
+		}
 	}
 
 	if (index < this->size) {
@@ -104,6 +135,8 @@ DEFINE_POOL_METHOD(inline void *)::AllocateItem(size_t size, size_t index)
 
 	this->first_unused = max(this->first_unused, index + 1);
 	this->items++;
+	this->allocations++;
+	if (Tfree_bitmap) this->MarkUsed(index);
 
 	Titem *item;
 	if (Tcache && this->alloc_cache != NULL) {
@@ -187,6 +220,7 @@ DEFINE_POOL_METHOD(void)::FreeItem(size_t index)
 		free(this->data[index]);
 	}
 	this->data[index] = NULL;
+	if (Tfree_bitmap) this->MarkFree(index);
 	this->first_free = min(this->first_free, index);
 	this->items--;
 	if (!this->cleaning) Titem::PostDestructor(index);
@@ -201,8 +235,12 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	}
 	assert(this->items == 0);
 	free(this->data);
+	free(this->free_bits);
+	free(this->free_words);
 	this->first_unused = this->first_free = this->size = 0;
 	this->data = NULL;
+	this->free_bits = NULL;
+	this->free_words = NULL;
 	this->cleaning = false;
 
 	if (Tcache) {
@@ -214,6 +252,16 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	}
 }
 
+DEFINE_POOL_METHOD(void)::GetStats(PoolStats *stats) const
+{
+	stats->name = this->name;
+	stats->items = this->items;
+	stats->first_unused = this->first_unused;
+	stats->size = this->size;
+	stats->max_size = Tmax_size;
+	stats->allocations = this->allocations;
+}
+
 #undef DEFINE_POOL_METHOD
 
 /**
@@ -225,6 +273,7 @@ DEFINE_POOL_METHOD(void)::CleanPool()
 	template void * name ## Pool::GetNew(size_t size); \
 	template void * name ## Pool::GetNew(size_t size, size_t index); \
 	template void name ## Pool::FreeItem(size_t index); \
-	template void name ## Pool::CleanPool();
+	template void name ## Pool::CleanPool(); \
+	template void name ## Pool::GetStats(PoolStats *stats) const;
 
 #endif /* POOL_FUNC_HPP */
@@ -14,6 +14,7 @@
 
 #include "smallvec_type.hpp"
 #include "enum_type.hpp"
+#include "bitmath_func.hpp"
 
 /** Various types of a pool. */
 enum PoolType {
@@ -28,6 +29,16 @@ DECLARE_ENUM_AS_BIT_SET(PoolType)
 
 typedef SmallVector<struct PoolBase *, 4> PoolVector; ///< Vector of pointers to PoolBase
 
+/** Statistics about the use of a pool. */
+struct PoolStats {
+	const char *name;    ///< Name of the pool.
+	size_t items;        ///< Number of used indexes.
+	size_t first_unused; ///< This and all higher indexes are free.
+	size_t size;         ///< Number of indexes memory has been allocated for.
+	size_t max_size;     ///< Maximum number of indexes.
+	uint64 allocations;  ///< Number of items allocated since the start.
+};
+
 /** Base class for base of all pools. */
 struct PoolBase {
 	const PoolType type; ///< Type of this pool.
@@ -60,6 +71,12 @@ struct PoolBase {
 	 */
 	virtual void CleanPool() = 0;
 
+	/**
+	 * Virtual method that gets the statistics of the pool.
+	 * @param[out] stats The statistics.
+	 */
+	virtual void GetStats(PoolStats *stats) const = 0;
+
 private:
 	/**
 	 * Dummy private copy constructor to prevent compilers from
@@ -77,9 +94,10 @@ private:
  * @tparam Tpool_type   Type of this pool
  * @tparam Tcache       Whether to perform 'alloc' caching, i.e. don't actually free/malloc just reuse the memory
  * @tparam Tzero        Whether to zero the memory
+ * @tparam Tfree_bitmap Whether to keep a bitmap of the free indexes, so finding the first free index does not need to scan the pool
  * @warning when Tcache is enabled *all* instances of this pool's item must be of the same size.
  */
-template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type = PT_NORMAL, bool Tcache = false, bool Tzero = true>
+template <class Titem, typename Tindex, size_t Tgrowth_step, size_t Tmax_size, PoolType Tpool_type = PT_NORMAL, bool Tcache = false, bool Tzero = true, bool Tfree_bitmap = false>
 struct Pool : PoolBase {
 	/* Ensure Tmax_size is within the bounds of Tindex. */
 	assert_compile((uint64)(Tmax_size - 1) >> 8 * sizeof(Tindex) == 0);
@@ -92,6 +110,7 @@ struct Pool : PoolBase {
 	size_t first_free;   ///< No item with index lower than this is free (doesn't say anything about this one!)
 	size_t first_unused; ///< This and all higher indexes are free (doesn't say anything about first_unused-1 !)
 	size_t items;        ///< Number of used indexes (non-NULL)
+	uint64 allocations;  ///< Number of items allocated since the start
 #ifdef OTTD_ASSERT
 	size_t checked;      ///< Number of items we checked for
 #endif /* OTTD_ASSERT */
@@ -101,6 +120,7 @@ struct Pool : PoolBase {
 
 	Pool(const char *name);
 	virtual void CleanPool();
+	virtual void GetStats(PoolStats *stats) const;
 
 	/**
 	 * Returns Titem with given index
@@ -142,7 +162,7 @@ struct Pool : PoolBase {
 	 * Base class for all PoolItems
 	 * @tparam Tpool The pool this item is going to be part of
 	 */
-	template <struct Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero> *Tpool>
+	template <struct Pool<Titem, Tindex, Tgrowth_step, Tmax_size, Tpool_type, Tcache, Tzero, Tfree_bitmap> *Tpool>
 	struct PoolItem {
 		Tindex index; ///< Index of this pool item
 
@@ -303,6 +323,32 @@ private:
 	/** Cache of freed pointers */
 	AllocCache *alloc_cache;
 
+	/* Only used when Tfree_bitmap is set. Every bit of a word of
+	 * free_words tells whether the word in free_bits with that
+	 * index has any free index, i.e. any set bit. */
+	uint32 *free_bits;   ///< Bitmap of the free indexes below #size.
+	uint32 *free_words;  ///< Bitmap of the words of #free_bits that have a free index.
+
+	/**
+	 * Mark an index as free in the bitmap of free indexes.
+	 * @param index The index that is free.
+	 */
+	inline void MarkFree(size_t index)
+	{
+		SetBit(this->free_bits[index / 32], index % 32);
+		SetBit(this->free_words[index / (32 * 32)], (index / 32) % 32);
+	}
+
+	/**
+	 * Mark an index as used in the bitmap of free indexes.
+	 * @param index The index that is used.
+	 */
+	inline void MarkUsed(size_t index)
+	{
+		ClrBit(this->free_bits[index / 32], index % 32);
+		if (this->free_bits[index / 32] == 0) ClrBit(this->free_words[index / (32 * 32)], (index / 32) % 32);
+	}
+
 	void *AllocateItem(size_t size, size_t index);
 	void ResizeFor(size_t index);
 	size_t FindFirstFree();
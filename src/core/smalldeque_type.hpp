@@ -0,0 +1,247 @@
+/* $Id$ */
+
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file smalldeque_type.hpp Double ended queue in a single block of memory. */
+
+#ifndef SMALLDEQUE_TYPE_HPP
+#define SMALLDEQUE_TYPE_HPP
+
+#include "alloc_func.hpp"
+#include "mem_func.hpp"
+#include "math_func.hpp"
+#include <iterator>
+
+/**
+ * Double ended queue that keeps its items in a single block of memory,
+ * with free space before and after them. Adding or removing items at
+ * either end is amortised constant time, iterating is a walk over linear
+ * memory. The interface follows the one of the standard containers, so
+ * it can replace a std::list or std::deque.
+ *
+ * @note Only suitable for simple types, as the items are moved with memmove.
+ * @note Unlike with a std::list, inserting or erasing items invalidates all
+ *       iterators, not just the ones to the erased items.
+ * @note Nothing is allocated as long as the queue is empty.
+ *
+ * @tparam T The type of the items stored.
+ */
+template <typename T>
+class SmallDeque {
+public:
+	typedef T *iterator;                                           ///< The iterator over the items.
+	typedef const T *const_iterator;                               ///< The const iterator over the items.
+	typedef std::reverse_iterator<iterator> reverse_iterator;             ///< The reverse iterator over the items.
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator; ///< The const reverse iterator over the items.
+
+protected:
+	static const uint MIN_CAPACITY = 4; ///< Capacity of the first allocation.
+
+	T *data;       ///< The allocated memory.
+	uint first;    ///< Position of the first item in #data.
+	uint items;    ///< The number of items stored.
+	uint capacity; ///< The number of items #data can hold.
+
+	/**
+	 * Make sure there is space for another item before the first or after
+	 * the last item. The items are centered in the (possibly grown) memory.
+	 */
+	void MakeRoom()
+	{
+		uint capacity = this->capacity;
+		/* Only move the items within the current memory if that leaves plenty of
+		 * room on both sides; otherwise moving would happen too often. */
+		if (capacity - this->items < max(capacity / 2, 2U)) capacity = max(MIN_CAPACITY, capacity * 2);
+
+		uint first = (capacity - this->items) / 2;
+		if (capacity == this->capacity) {
+			MemMoveT(this->data + first, this->data + this->first, this->items);
+		} else {
+			T *data = MallocT<T>(capacity);
+			MemCpyT(data + first, this->data + this->first, this->items);
+			free(this->data);
+			this->data = data;
+			this->capacity = capacity;
+		}
+		this->first = first;
+	}
+
+public:
+	SmallDeque() : data(NULL), first(0), items(0), capacity(0) { }
+
+	/**
+	 * Create a copy of another queue.
+	 * @param other The queue to copy.
+	 */
+	SmallDeque(const SmallDeque &other) : data(NULL), first(0), items(0), capacity(0)
+	{
+		*this = other;
+	}
+
+	~SmallDeque()
+	{
+		free(this->data);
+	}
+
+	/**
+	 * Replace the items with copies of the items of another queue.
+	 * @param other The queue to copy.
+	 * @return This queue.
+	 */
+	SmallDeque &operator=(const SmallDeque &other)
+	{
+		if (this == &other) return *this;
+
+		if (other.items > this->capacity) {
+			free(this->data);
+			this->data = MallocT<T>(other.items);
+			this->capacity = other.items;
+		}
+		this->first = (this->capacity - other.items) / 2;
+		this->items = other.items;
+		MemCpyT(this->begin(), other.begin(), other.items);
+		return *this;
+	}
+
+	/**
+	 * Remove all items, but keep the memory.
+	 */
+	inline void clear()
+	{
+		this->first = this->capacity / 2;
+		this->items = 0;
+	}
+
+	/**
+	 * Exchange the contents with another queue.
+	 * @param other The queue to exchange with.
+	 */
+	inline void swap(SmallDeque &other)
+	{
+		Swap(this->data, other.data);
+		Swap(this->first, other.first);
+		Swap(this->items, other.items);
+		Swap(this->capacity, other.capacity);
+	}
+
+	/**
+	 * Get the number of items.
+	 * @return The number of items.
+	 */
+	inline size_t size() const { return this->items; }
+
+	/**
+	 * Check whether there are no items.
+	 * @return True iff there are no items.
+	 */
+	inline bool empty() const { return this->items == 0; }
+
+	inline iterator begin() { return this->data + this->first; }                  ///< @return Iterator to the first item.
+	inline const_iterator begin() const { return this->data + this->first; }      ///< @return Iterator to the first item.
+	inline iterator end() { return this->begin() + this->items; }                 ///< @return Iterator past the last item.
+	inline const_iterator end() const { return this->begin() + this->items; }     ///< @return Iterator past the last item.
+	inline reverse_iterator rbegin() { return reverse_iterator(this->end()); }    ///< @return Reverse iterator to the last item.
+	inline const_reverse_iterator rbegin() const { return const_reverse_iterator(this->end()); } ///< @return Reverse iterator to the last item.
+	inline reverse_iterator rend() { return reverse_iterator(this->begin()); }    ///< @return Reverse iterator before the first item.
+	inline const_reverse_iterator rend() const { return const_reverse_iterator(this->begin()); } ///< @return Reverse iterator before the first item.
+
+	inline T &front() { return this->data[this->first]; }                         ///< @return The first item.
+	inline const T &front() const { return this->data[this->first]; }             ///< @return The first item.
+	inline T &back() { return this->data[this->first + this->items - 1]; }        ///< @return The last item.
+	inline const T &back() const { return this->data[this->first + this->items - 1]; } ///< @return The last item.
+
+	/**
+	 * Get an item by its position.
+	 * @param index The position of the item.
+	 * @return The item.
+	 */
+	inline T &operator[](uint index) { return this->data[this->first + index]; }
+
+	/**
+	 * Get an item by its position.
+	 * @param index The position of the item.
+	 * @return The item.
+	 */
+	inline const T &operator[](uint index) const { return this->data[this->first + index]; }
+
+	/**
+	 * Add an item after the last one.
+	 * @param item The item to add.
+	 */
+	inline void push_back(const T &item)
+	{
+		if (this->first + this->items == this->capacity) this->MakeRoom();
+		this->data[this->first + this->items++] = item;
+	}
+
+	/**
+	 * Add an item before the first one.
+	 * @param item The item to add.
+	 */
+	inline void push_front(const T &item)
+	{
+		if (this->first == 0) this->MakeRoom();
+		this->data[--this->first] = item;
+		this->items++;
+	}
+
+	/** Remove the last item. */
+	inline void pop_back()
+	{
+		this->items--;
+	}
+
+	/** Remove the first item. */
+	inline void pop_front()
+	{
+		this->first++;
+		this->items--;
+	}
+
+	/**
+	 * Insert an item before the given position. The items on the shorter
+	 * side of the position are moved to make room.
+	 * @param pos The position to insert at.
+	 * @param item The item to insert.
+	 * @return Iterator to the inserted item.
+	 */
+	iterator insert(iterator pos, const T &item)
+	{
+		uint index = pos - this->begin();
+		if (index < this->items / 2) {
+			this->push_front(item);
+			MemMoveT(this->begin(), this->begin() + 1, index);
+		} else {
+			this->push_back(item);
+			MemMoveT(this->begin() + index + 1, this->begin() + index, this->items - index - 1);
+		}
+		this->data[this->first + index] = item;
+		return this->begin() + index;
+	}
+
+	/**
+	 * Remove the item at the given position. The items on the shorter side
+	 * of the position are moved to close the gap.
+	 * @param pos The position of the item to remove.
+	 * @return Iterator to the item after the removed one.
+	 */
+	iterator erase(iterator pos)
+	{
+		uint index = pos - this->begin();
+		if (index < this->items / 2) {
+			MemMoveT(this->begin() + 1, this->begin(), index);
+			this->pop_front();
+		} else {
+			MemMoveT(this->begin() + index, this->begin() + index + 1, this->items - index - 1);
+			this->pop_back();
+		}
+		return this->begin() + index;
+	}
+};
+
+#endif /* SMALLDEQUE_TYPE_HPP */
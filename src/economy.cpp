@@ -919,6 +919,7 @@ void InitializeEconomy()
 	_economy.inflation_prices = _economy.inflation_payment = 1 << 16;
 	ClearCargoPickupMonitoring();
 	ClearCargoDeliveryMonitoring();
+	ResetLoadingStations();
 }
 
 /**
@@ -1223,6 +1224,7 @@ void PrepareUnload(Vehicle *front_v)
 {
 	Station *curr_station = Station::Get(front_v->last_station_visited);
 	curr_station->loading_vehicles.push_back(front_v);
+	UpdateLoadingStation(curr_station);
 
 	/* At this moment loading cannot be finished */
 	ClrBit(front_v->vehicle_flags, VF_LOADING_FINISHED);
@@ -1855,12 +1857,80 @@ static void LoadUnloadVehicle(Vehicle *front)
 	}
 }
 
+/** Stations with vehicles that are loading or unloading, sorted by index. */
+static SmallVector<Station *, 32> _loading_stations;
+/** Number of stations that were loading or unloading vehicles in the last tick. */
+uint _loading_stations_last_tick;
+
+/**
+ * Find the position of a station in the list of stations with loading vehicles,
+ * or the position where it would have to be inserted.
+ * @param index The index of the station.
+ * @return The position.
+ */
+static uint FindLoadingStationPosition(StationID index)
+{
+	uint begin = 0;
+	uint end = _loading_stations.Length();
+	while (begin < end) {
+		uint mid = (begin + end) / 2;
+		if (_loading_stations[mid]->index < index) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+	return begin;
+}
+
+/**
+ * Add a station to or remove it from the stations that are handled by
+ * #LoadUnloadStations, depending on whether any vehicles are loading there.
+ * Must be called whenever a vehicle is added to or removed from the loading
+ * vehicles of a station.
+ * @param st The station.
+ */
+void UpdateLoadingStation(Station *st)
+{
+	uint pos = FindLoadingStationPosition(st->index);
+	bool listed = pos < _loading_stations.Length() && _loading_stations[pos] == st;
+
+	if (st->loading_vehicles.empty()) {
+		if (listed) _loading_stations.ErasePreservingOrder(pos);
+	} else if (!listed) {
+		_loading_stations.Append();
+		MemMoveT(_loading_stations.Begin() + pos + 1, _loading_stations.Begin() + pos, _loading_stations.Length() - pos - 1);
+		_loading_stations[pos] = st;
+	}
+}
+
+/**
+ * Rebuild the list of stations with loading vehicles, e.g. after loading a
+ * savegame when the loading vehicles have been set up directly.
+ */
+void RebuildLoadingStations()
+{
+	_loading_stations.Clear();
+
+	Station *st;
+	FOR_ALL_STATIONS(st) {
+		if (!st->loading_vehicles.empty()) *_loading_stations.Append() = st;
+	}
+}
+
+/** Forget all stations with loading vehicles, as all stations are gone. */
+void ResetLoadingStations()
+{
+	_loading_stations.Reset();
+	_loading_stations_last_tick = 0;
+}
+
 /**
  * Load/unload the vehicles in this station according to the order
  * they entered.
  * @param st the station to do the loading/unloading for
  */
-void LoadUnloadStation(Station *st)
+static void LoadUnloadStation(Station *st)
 {
 	/* No vehicle is here... */
 	if (st->loading_vehicles.empty()) return;
@@ -1901,6 +1971,18 @@ void LoadUnloadStation(Station *st)
 	_cargo_delivery_destinations.Clear();
 }
 
+/**
+ * Load/unload the vehicles at all stations where vehicles are loading, in
+ * order of the stations' indexes.
+ */
+void LoadUnloadStations()
+{
+	_loading_stations_last_tick = _loading_stations.Length();
+	for (uint i = 0; i < _loading_stations.Length(); i++) {
+		LoadUnloadStation(_loading_stations[i]);
+	}
+}
+
 /**
  * Monthly update of the economic data (of the companies as well as economic fluctuations).
  */
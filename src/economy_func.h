@@ -33,8 +33,13 @@ void StartupIndustryDailyChanges(bool init_counter);
 Money GetTransportedGoodsIncome(uint num_pieces, uint dist, byte transit_days, CargoID cargo_type);
 uint MoveGoodsToStation(CargoID type, uint amount, SourceType source_type, SourceID source_id, const StationList *all_stations);
 
+extern uint _loading_stations_last_tick;
+
 void PrepareUnload(Vehicle *front_v);
-void LoadUnloadStation(Station *st);
+void UpdateLoadingStation(Station *st);
+void RebuildLoadingStations();
+void ResetLoadingStations();
+void LoadUnloadStations();
 
 Money GetPrice(Price index, uint cost_factor, const struct GRFFile *grf_file, int shift = 0);
 
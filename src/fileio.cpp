@@ -28,6 +28,12 @@
 #include <sys/stat.h>
 #include <algorithm>
 
+#if defined(UNIX) && !defined(__MORPHOS__) && !defined(__AMIGA__)
+/* Files can be read through a memory mapping. */
+#	define WITH_FILE_MAPPING
+#	include <sys/mman.h>
+#endif
+
 #ifdef WITH_XDG_BASEDIR
 #include "basedir.h"
 #endif
@@ -40,11 +46,15 @@ struct Fio {
 	byte *buffer, *buffer_end;             ///< position pointer in local buffer and last valid byte of buffer
 	size_t pos;                            ///< current (system) position in file
 	FILE *cur_fh;                          ///< current file handle
+	byte *cur_map;                         ///< mapping of the current file, or \c NULL when it is read through #cur_fh
+	size_t cur_map_size;                   ///< size of #cur_map
 	const char *filename;                  ///< current filename
 	FILE *handles[MAX_FILE_SLOTS];         ///< array of file handles we can have open
 	byte buffer_start[FIO_BUFFER_SIZE];    ///< local buffer when read from file
 	const char *filenames[MAX_FILE_SLOTS]; ///< array of filenames we (should) have open
 	char *shortnames[MAX_FILE_SLOTS];      ///< array of short names for spriteloader's use
+	byte *maps[MAX_FILE_SLOTS];            ///< array of mappings of the files, or \c NULL for files that are not mapped
+	size_t map_sizes[MAX_FILE_SLOTS];      ///< array of sizes of the mappings
 #if defined(LIMITED_FDS)
 	uint open_handles;                     ///< current amount of open handles
 	uint usage_count[MAX_FILE_SLOTS];      ///< count how many times this file has been opened
@@ -86,6 +96,13 @@ const char *FioGetFilename(uint8 slot)
 void FioSeekTo(size_t pos, int mode)
 {
 	if (mode == SEEK_CUR) pos += FioGetPos();
+	if (_fio.cur_map != NULL) {
+		/* Use the whole mapping as buffer. */
+		_fio.buffer = _fio.cur_map + min(pos, _fio.cur_map_size);
+		_fio.buffer_end = _fio.cur_map + _fio.cur_map_size;
+		_fio.pos = _fio.cur_map_size;
+		return;
+	}
 	_fio.buffer = _fio.buffer_end = _fio.buffer_start + FIO_BUFFER_SIZE;
 	_fio.pos = pos;
 	if (fseek(_fio.cur_fh, _fio.pos, SEEK_SET) < 0) {
@@ -120,6 +137,8 @@ void FioSeekToFile(uint8 slot, size_t pos)
 	f = _fio.handles[slot];
 	assert(f != NULL);
 	_fio.cur_fh = f;
+	_fio.cur_map = _fio.maps[slot];
+	_fio.cur_map_size = _fio.map_sizes[slot];
 	_fio.filename = _fio.filenames[slot];
 	FioSeekTo(pos, SEEK_SET);
 }
@@ -131,6 +150,9 @@ void FioSeekToFile(uint8 slot, size_t pos)
 byte FioReadByte()
 {
 	if (_fio.buffer == _fio.buffer_end) {
+		/* The whole mapping is the buffer, so this is the end of the file. */
+		if (_fio.cur_map != NULL) return 0;
+
 		_fio.buffer = _fio.buffer_start;
 		size_t size = fread(_fio.buffer, 1, FIO_BUFFER_SIZE, _fio.cur_fh);
 		_fio.pos += size;
@@ -184,6 +206,13 @@ uint32 FioReadDword()
  */
 void FioReadBlock(void *ptr, size_t size)
 {
+	if (_fio.cur_map != NULL) {
+		size_t len = min<size_t>(size, _fio.buffer_end - _fio.buffer);
+		memcpy(ptr, _fio.buffer, len);
+		_fio.buffer += len;
+		return;
+	}
+
 	FioSeekTo(FioGetPos(), SEEK_SET);
 	_fio.pos += fread(ptr, 1, size, _fio.cur_fh);
 }
@@ -197,6 +226,10 @@ static inline void FioCloseFile(int slot)
 	if (_fio.handles[slot] != NULL) {
 		fclose(_fio.handles[slot]);
 
+		if (_fio.maps[slot] != NULL) FioUnmapFile(_fio.maps[slot], _fio.map_sizes[slot]);
+		_fio.maps[slot] = NULL;
+		if (_fio.cur_fh == _fio.handles[slot]) _fio.cur_map = NULL;
+
 		free(_fio.shortnames[slot]);
 		_fio.shortnames[slot] = NULL;
 
@@ -259,6 +292,8 @@ void FioOpenFile(int slot, const char *filename, Subdirectory subdir)
 
 	FioCloseFile(slot); // if file was opened before, close it
 	_fio.handles[slot] = f;
+	/* NewGRFs are read several times; reading them through a mapping saves copying everything through stdio. */
+	_fio.maps[slot] = FioMapFile(f, &_fio.map_sizes[slot]);
 	_fio.filenames[slot] = filename;
 
 	/* Store the filename without path and extension */
@@ -534,6 +569,44 @@ FILE *FioFOpenFile(const char *filename, const char *mode, Subdirectory subdir,
 	return f;
 }
 
+/**
+ * Map a whole opened file into memory, so it can be read directly from the
+ * page cache instead of being copied through the buffers of stdio.
+ * @param f The file to map; it has to stay open as long as the mapping is used.
+ * @param[out] size The size of the file, and thus of the mapping.
+ * @return The mapping, or \c NULL when the file cannot be mapped and has to be read with the normal file functions.
+ */
+byte *FioMapFile(FILE *f, size_t *size)
+{
+	*size = 0;
+#if defined(WITH_FILE_MAPPING)
+	struct stat st;
+	if (fstat(fileno(f), &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || (uint64)st.st_size != (size_t)st.st_size) return NULL;
+
+	void *map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(f), 0);
+	if (map == MAP_FAILED) return NULL;
+
+	*size = (size_t)st.st_size;
+	return (byte *)map;
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * Remove the mapping of a file made by #FioMapFile.
+ * @param map  The mapping.
+ * @param size The size of the mapping.
+ */
+void FioUnmapFile(byte *map, size_t size)
+{
+#if defined(WITH_FILE_MAPPING)
+	munmap(map, size);
+#else
+	NOT_REACHED();
+#endif
+}
+
 /**
  * Create a directory with the given name
  * @param name the new name of the directory
@@ -50,6 +50,8 @@ static inline bool IsValidSearchPath(Searchpath sp)
 
 void FioFCloseFile(FILE *f);
 FILE *FioFOpenFile(const char *filename, const char *mode, Subdirectory subdir, size_t *filesize = NULL);
+byte *FioMapFile(FILE *f, size_t *size);
+void FioUnmapFile(byte *map, size_t size);
 bool FioCheckFileExists(const char *filename, Subdirectory subdir);
 char *FioGetFullPath(char *buf, size_t buflen, Searchpath sp, Subdirectory subdir, const char *filename);
 char *FioFindFullPath(char *buf, size_t buflen, Subdirectory subdir, const char *filename);
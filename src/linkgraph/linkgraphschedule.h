@@ -61,6 +61,18 @@ public:
 	void SpawnAll();
 	void ShiftDates(int interval);
 
+	/**
+	 * Get the number of link graphs waiting for a job to be spawned.
+	 * @return Length of the queue.
+	 */
+	uint GetQueuedCount() const { return (uint)this->schedule.size(); }
+
+	/**
+	 * Get the number of link graph jobs that have been spawned but not joined yet.
+	 * @return Number of running jobs.
+	 */
+	uint GetRunningCount() const { return (uint)this->running.size(); }
+
 	/**
 	 * Queue a link graph for execution.
 	 * @param lg Link graph to be queued.
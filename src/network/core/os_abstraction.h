@@ -186,6 +186,19 @@ static inline void OTTDfreeaddrinfo(struct addrinfo *ai)
 #	include <netdb.h>
 #endif /* UNIX */
 
+/* Multiple packets can be sent with a single call. */
+#if defined(UNIX) && !defined(__OS2__) && !defined(__BEOS__) && !defined(__MORPHOS__) && !defined(__AMIGA__)
+#	include <sys/uio.h>
+#	define HAVE_WRITEV
+#endif
+
+/* Linux can wait for events on any number of sockets, without the FD_SETSIZE limit of select(). */
+#if defined(UNIX) && defined(__linux__)
+#	include <sys/epoll.h>
+#	include <poll.h>
+#	define WITH_EPOLL
+#endif
+
 #ifdef __BEOS__
 	typedef int socklen_t;
 #endif
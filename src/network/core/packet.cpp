@@ -15,9 +15,48 @@
 
 #include "../../stdafx.h"
 #include "../../string_func.h"
+#include "../../thread/thread.h"
 
 #include "packet.h"
 
+/** Maximum number of unused packet buffers that are kept for reuse. */
+static const uint PACKET_BUFFER_POOL_SIZE = 256;
+
+static byte *_packet_buffer_pool[PACKET_BUFFER_POOL_SIZE]; ///< Unused buffers of #SEND_MTU bytes.
+static uint _packet_buffer_pool_count = 0;                 ///< Number of buffers in #_packet_buffer_pool.
+/** Packets are also made by the UDP threads, so guard the pool. */
+static ThreadMutex *_packet_buffer_pool_mutex = ThreadMutex::New();
+
+/**
+ * Get a buffer for a packet, reusing the buffer of an earlier packet when possible.
+ * @return A buffer of #SEND_MTU bytes.
+ */
+static byte *AllocatePacketBuffer()
+{
+	byte *buffer = NULL;
+	_packet_buffer_pool_mutex->BeginCritical();
+	if (_packet_buffer_pool_count > 0) buffer = _packet_buffer_pool[--_packet_buffer_pool_count];
+	_packet_buffer_pool_mutex->EndCritical();
+
+	return buffer != NULL ? buffer : MallocT<byte>(SEND_MTU);
+}
+
+/**
+ * Return the buffer of a packet to the pool, or free it when the pool is full.
+ * @param buffer The buffer of #SEND_MTU bytes.
+ */
+static void FreePacketBuffer(byte *buffer)
+{
+	_packet_buffer_pool_mutex->BeginCritical();
+	if (_packet_buffer_pool_count < PACKET_BUFFER_POOL_SIZE) {
+		_packet_buffer_pool[_packet_buffer_pool_count++] = buffer;
+		buffer = NULL;
+	}
+	_packet_buffer_pool_mutex->EndCritical();
+
+	free(buffer);
+}
+
 /**
  * Create a packet that is used to read from a network socket
  * @param cs the socket handler associated with the socket we are reading from
@@ -30,7 +69,8 @@ Packet::Packet(NetworkSocketHandler *cs)
 	this->next   = NULL;
 	this->pos    = 0; // We start reading from here
 	this->size   = 0;
-	this->buffer = MallocT<byte>(SEND_MTU);
+	this->buffer = AllocatePacketBuffer();
+	this->shrunk = false;
 }
 
 /**
@@ -45,8 +85,9 @@ Packet::Packet(PacketType type)
 	/* Skip the size so we can write that in before sending the packet */
 	this->pos                  = 0;
 	this->size                 = sizeof(PacketSize);
-	this->buffer               = MallocT<byte>(SEND_MTU);
+	this->buffer               = AllocatePacketBuffer();
 	this->buffer[this->size++] = type;
+	this->shrunk               = false;
 }
 
 /**
@@ -54,7 +95,11 @@ Packet::Packet(PacketType type)
  */
 Packet::~Packet()
 {
-	free(this->buffer);
+	if (this->shrunk) {
+		free(this->buffer);
+	} else {
+		FreePacketBuffer(this->buffer);
+	}
 }
 
 /**
@@ -70,6 +115,21 @@ void Packet::PrepareToSend()
 	this->pos  = 0; // We start reading from here
 }
 
+/**
+ * Move the packet to a buffer of just its size, and give the buffer of
+ * #SEND_MTU bytes back for reuse. For packets that wait in a queue.
+ */
+void Packet::ShrinkBuffer()
+{
+	if (this->shrunk) return;
+
+	byte *buffer = MallocT<byte>(this->size);
+	memcpy(buffer, this->buffer, this->size);
+	FreePacketBuffer(this->buffer);
+	this->buffer = buffer;
+	this->shrunk = true;
+}
+
 /*
  * The next couple of functions make sure we can send
  *  uint8, uint16, uint32 and uint64 endian-safe
@@ -142,6 +202,22 @@ void Packet::Send_uint64(uint64 data)
 	this->buffer[this->size++] = GB(data, 56, 8);
 }
 
+/**
+ * Package a 32 bits integer in the packet using a variable number of bytes;
+ * seven bits per byte, least significant first, with the high bit telling
+ * another byte follows. Small values thus take a single byte.
+ * @param data The data to send.
+ */
+void Packet::Send_varint(uint32 data)
+{
+	do {
+		assert(this->size < SEND_MTU);
+		byte b = GB(data, 0, 7);
+		data >>= 7;
+		this->buffer[this->size++] = b | (data != 0 ? 0x80 : 0);
+	} while (data != 0);
+}
+
 /**
  * Sends a string over the network. It sends out
  * the string + '\0'. No size-byte or something.
@@ -279,6 +355,27 @@ uint64 Packet::Recv_uint64()
 	return n;
 }
 
+/**
+ * Read a 32 bits integer that was sent with #Send_varint from the packet.
+ * @return The read data.
+ */
+uint32 Packet::Recv_varint()
+{
+	uint32 n = 0;
+
+	for (uint shift = 0; shift < 35; shift += 7) {
+		if (!this->CanReadFromPacket(1)) return 0;
+
+		byte b = this->buffer[this->pos++];
+		n |= (uint32)GB(b, 0, 7) << shift;
+		if (!HasBit(b, 7)) return n;
+	}
+
+	/* More bytes than a 32 bits integer can ever need. */
+	this->cs->NetworkSocketHandler::CloseConnection();
+	return 0;
+}
+
 /**
  * Reads a string till it finds a '\0' in the stream.
  * @param buffer The buffer to put the data into.
@@ -58,6 +58,8 @@ struct Packet {
 private:
 	/** Socket we're associated with. */
 	NetworkSocketHandler *cs;
+	/** Whether #buffer has been shrunk to the size of the packet, so it cannot be reused for another packet. */
+	bool shrunk;
 
 public:
 	Packet(NetworkSocketHandler *cs);
@@ -66,12 +68,20 @@ public:
 
 	/* Sending/writing of packets */
 	void PrepareToSend();
+	void ShrinkBuffer();
+
+	/**
+	 * Whether the buffer of this packet goes back to the pool of buffers once the packet is freed.
+	 * @return true when the buffer has not been shrunk.
+	 */
+	bool HasPooledBuffer() const { return !this->shrunk; }
 
 	void Send_bool  (bool   data);
 	void Send_uint8 (uint8  data);
 	void Send_uint16(uint16 data);
 	void Send_uint32(uint32 data);
 	void Send_uint64(uint64 data);
+	void Send_varint(uint32 data);
 	void Send_string(const char *data);
 
 	/* Reading/receiving of packets */
@@ -84,6 +94,7 @@ public:
 	uint16 Recv_uint16();
 	uint32 Recv_uint32();
 	uint64 Recv_uint64();
+	uint32 Recv_varint();
 	void   Recv_string(char *buffer, size_t size, StringValidationSettings settings = SVS_REPLACE_WITH_QUESTION_MARK);
 };
 
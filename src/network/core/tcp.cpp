@@ -18,15 +18,30 @@
 
 #include "tcp.h"
 
+#ifdef HAVE_WRITEV
+/** Maximum number of packets handed to writev() at once; the minimum IOV_MAX POSIX guarantees. */
+static const int SEND_PACKETS_BATCH_SIZE = 16;
+#endif
+
+/** Packets smaller than this are always moved to a buffer of their own size when they have to wait in a queue. */
+static const PacketSize SHRINK_PACKET_SIZE = SEND_MTU / 4;
+/** Maximum number of packets with a pooled buffer of #SEND_MTU bytes the send queue of a socket may hold. */
+static const uint MAX_QUEUED_POOLED_PACKETS = 16;
+
+NetworkTCPSendStats _network_tcp_send_stats; ///< Statistics of sending over all TCP connections.
+
 /**
  * Construct a socket handler for a TCP connection.
  * @param s The just opened TCP connection.
  */
 NetworkTCPSocketHandler::NetworkTCPSocketHandler(SOCKET s) :
 		NetworkSocketHandler(),
-		packet_queue(NULL), packet_recv(NULL),
-		sock(s), writable(false)
+		packet_queue(NULL), packet_recv(NULL), queued_pooled_packets(0),
+		sock(s), writable(false), readable(false), bytes_sent(0)
 {
+#ifdef WITH_EPOLL
+	this->polled = false;
+#endif
 }
 
 NetworkTCPSocketHandler::~NetworkTCPSocketHandler()
@@ -40,6 +55,7 @@ NetworkTCPSocketHandler::~NetworkTCPSocketHandler()
 NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection(bool error)
 {
 	this->writable = false;
+	this->readable = false;
 	NetworkSocketHandler::CloseConnection(error);
 
 	/* Free all pending and partially received packets */
@@ -48,6 +64,7 @@ NetworkRecvStatus NetworkTCPSocketHandler::CloseConnection(bool error)
 		delete this->packet_queue;
 		this->packet_queue = p;
 	}
+	this->queued_pooled_packets = 0;
 	delete this->packet_recv;
 	this->packet_recv = NULL;
 
@@ -69,8 +86,15 @@ void NetworkTCPSocketHandler::SendPacket(Packet *packet)
 
 	/* Reallocate the packet as in 99+% of the times we send at most 25 bytes and
 	 * keeping the other 1400+ bytes wastes memory, especially when someone tries
-	 * to do a denial of service attack! */
-	packet->buffer = ReallocT(packet->buffer, packet->size);
+	 * to do a denial of service attack! A packet that is likely sent right away
+	 * keeps its buffer, so the buffer can be reused by the next packet. Of the
+	 * large packets that have to wait, e.g. the map, only a limited number keeps
+	 * its buffer; copying them all would cost more than it saves. */
+	if ((this->packet_queue != NULL || !this->writable) &&
+			(packet->size < SHRINK_PACKET_SIZE || this->queued_pooled_packets >= MAX_QUEUED_POOLED_PACKETS)) {
+		packet->ShrinkBuffer();
+	}
+	if (packet->HasPooledBuffer()) this->queued_pooled_packets++;
 
 	/* Locate last packet buffered for the client */
 	p = this->packet_queue;
@@ -90,22 +114,30 @@ void NetworkTCPSocketHandler::SendPacket(Packet *packet)
  *   2) the OS reports back that it can not send any more
  *      data right now (full network-buffer, it happens ;))
  *   3) sending took too long
+ * Where possible multiple packets are handed to the OS at once.
  * @param closing_down Whether we are closing down the connection.
  * @return \c true if a (part of a) packet could be sent and
  *         the connection is not closed yet.
  */
 SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 {
-	ssize_t res;
-	Packet *p;
-
 	/* We can not write to this socket!! */
 	if (!this->writable) return SPS_NONE_SENT;
 	if (!this->IsConnected()) return SPS_CLOSED;
 
-	p = this->packet_queue;
-	while (p != NULL) {
-		res = send(this->sock, (const char*)p->buffer + p->pos, p->size - p->pos, 0);
+	while (this->packet_queue != NULL) {
+#ifdef HAVE_WRITEV
+		struct iovec iov[SEND_PACKETS_BATCH_SIZE];
+		int count = 0;
+		for (Packet *p = this->packet_queue; p != NULL && count < SEND_PACKETS_BATCH_SIZE; p = p->next, count++) {
+			iov[count].iov_base = p->buffer + p->pos;
+			iov[count].iov_len = p->size - p->pos;
+		}
+		ssize_t res = writev(this->sock, iov, count);
+#else
+		Packet *p = this->packet_queue;
+		ssize_t res = send(this->sock, (const char*)p->buffer + p->pos, p->size - p->pos, 0);
+#endif
 		if (res == -1) {
 			int err = GET_LAST_ERROR();
 			if (err != EWOULDBLOCK) {
@@ -116,6 +148,8 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 				}
 				return SPS_CLOSED;
 			}
+			/* Wait until the OS tells us there is room again. */
+			this->writable = false;
 			return SPS_PARTLY_SENT;
 		}
 		if (res == 0) {
@@ -124,16 +158,25 @@ SendPacketsState NetworkTCPSocketHandler::SendPackets(bool closing_down)
 			return SPS_CLOSED;
 		}
 
-		p->pos += res;
+		_network_tcp_send_stats.calls++;
+		_network_tcp_send_stats.bytes += res;
+		this->bytes_sent += res;
+
+		/* Remove the packets that have been sent completely. */
+		while (res > 0) {
+			Packet *p = this->packet_queue;
+			PacketSize sent = (PacketSize)min<ssize_t>(res, p->size - p->pos);
+			p->pos += sent;
+			res -= sent;
+
+			/* Is this packet only partially sent? */
+			if (p->pos != p->size) return SPS_PARTLY_SENT;
 
-		/* Is this packet sent? */
-		if (p->pos == p->size) {
 			/* Go to the next packet */
 			this->packet_queue = p->next;
+			if (p->HasPooledBuffer()) this->queued_pooled_packets--;
 			delete p;
-			p = this->packet_queue;
-		} else {
-			return SPS_PARTLY_SENT;
+			_network_tcp_send_stats.packets++;
 		}
 	}
 
@@ -170,6 +213,7 @@ Packet *NetworkTCPSocketHandler::ReceivePacket()
 					return NULL;
 				}
 				/* Connection would block, so stop for now */
+				this->readable = false;
 				return NULL;
 			}
 			if (res == 0) {
@@ -201,6 +245,7 @@ Packet *NetworkTCPSocketHandler::ReceivePacket()
 				return NULL;
 			}
 			/* Connection would block */
+			this->readable = false;
 			return NULL;
 		}
 		if (res == 0) {
@@ -226,6 +271,18 @@ Packet *NetworkTCPSocketHandler::ReceivePacket()
  */
 bool NetworkTCPSocketHandler::CanSendReceive()
 {
+#ifdef WITH_EPOLL
+	/* Unlike select(), poll() works with any socket number. */
+	struct pollfd pfd;
+	pfd.fd = this->sock;
+	pfd.events = POLLIN | POLLOUT;
+	pfd.revents = 0;
+
+	if (poll(&pfd, 1, 0) < 0) return false;
+
+	this->writable = (pfd.revents & POLLOUT) != 0;
+	this->readable = (pfd.revents & (POLLIN | POLLHUP | POLLERR)) != 0;
+#else
 	fd_set read_fd, write_fd;
 	struct timeval tv;
 
@@ -243,7 +300,9 @@ bool NetworkTCPSocketHandler::CanSendReceive()
 #endif
 
 	this->writable = !!FD_ISSET(this->sock, &write_fd);
-	return FD_ISSET(this->sock, &read_fd) != 0;
+	this->readable = FD_ISSET(this->sock, &read_fd) != 0;
+#endif
+	return this->readable;
 }
 
 #endif /* ENABLE_NETWORK */
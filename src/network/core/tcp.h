@@ -27,14 +27,30 @@ enum SendPacketsState {
 	SPS_ALL_SENT,    ///< All packets in the queue are sent.
 };
 
+/** Statistics of the sending of packets over TCP connections. */
+struct NetworkTCPSendStats {
+	uint64 frames;  ///< Number of times the packets of all connections got sent.
+	uint64 calls;   ///< Number of send()/writev() calls that sent something.
+	uint64 bytes;   ///< Number of bytes sent by those calls.
+	uint64 packets; ///< Number of packets that have been sent completely.
+};
+
+extern NetworkTCPSendStats _network_tcp_send_stats;
+
 /** Base socket handler for all TCP sockets */
 class NetworkTCPSocketHandler : public NetworkSocketHandler {
 private:
 	Packet *packet_queue;     ///< Packets that are awaiting delivery
 	Packet *packet_recv;      ///< Partially received packet
+	uint queued_pooled_packets; ///< Number of packets in #packet_queue with a pooled buffer.
 public:
 	SOCKET sock;              ///< The socket currently connected to
 	bool writable;            ///< Can we write to this socket?
+	bool readable;            ///< May there be something to read from this socket?
+	uint64 bytes_sent;        ///< Number of bytes sent over this socket.
+#ifdef WITH_EPOLL
+	bool polled;              ///< Is this socket registered with the event poll of its listener?
+#endif
 
 	/**
 	 * Whether this socket is currently bound to a socket.
@@ -42,6 +58,17 @@ public:
 	 */
 	bool IsConnected() const { return this->sock != INVALID_SOCKET; }
 
+	/**
+	 * Close the descriptor of the socket in a forked process. Unlike
+	 * #CloseConnection nothing else is touched, as the parent process
+	 * keeps using the connection.
+	 */
+	void CloseInheritedSocket()
+	{
+		if (this->sock != INVALID_SOCKET) closesocket(this->sock);
+		this->sock = INVALID_SOCKET;
+	}
+
 	virtual NetworkRecvStatus CloseConnection(bool error = true);
 	virtual void SendPacket(Packet *packet);
 	SendPacketsState SendPackets(bool closing_down = false);
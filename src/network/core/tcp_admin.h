@@ -34,6 +34,7 @@ enum PacketAdminType {
 	ADMIN_PACKET_ADMIN_RCON,             ///< The admin sends a remote console command.
 	ADMIN_PACKET_ADMIN_GAMESCRIPT,       ///< The admin sends a JSON string for the GameScript.
 	ADMIN_PACKET_ADMIN_PING,             ///< The admin sends a ping to the server, expecting a ping-reply (PONG) packet.
+	ADMIN_PACKET_ADMIN_COMPANY_FILTER,   ///< The admin tells the server which companies and fields of the economy or statistics it wants.
 
 	ADMIN_PACKET_SERVER_FULL = 100,      ///< The server tells the admin it cannot accept the admin.
 	ADMIN_PACKET_SERVER_BANNED,          ///< The server tells the admin it is banned.
@@ -63,6 +64,10 @@ enum PacketAdminType {
 	ADMIN_PACKET_SERVER_GAMESCRIPT,      ///< The server gives the admin information from the GameScript in JSON.
 	ADMIN_PACKET_SERVER_RCON_END,        ///< The server indicates that the remote console command has completed.
 	ADMIN_PACKET_SERVER_PONG,            ///< The server replies to a ping request from the admin.
+	ADMIN_PACKET_SERVER_TICK_PROFILE,    ///< The server gives the admin the durations of the phases of the game loop.
+	ADMIN_PACKET_SERVER_COMPANY_DELTA,   ///< The server gives the admin the changed fields of the economy or statistics of a company.
+	ADMIN_PACKET_SERVER_HEALTH,          ///< The server gives the admin an overview of its performance.
+	ADMIN_PACKET_SERVER_CLIENT_HEALTH,   ///< The server gives the admin the performance of the connection to a client.
 
 	INVALID_ADMIN_PACKET = 0xFF,         ///< An invalid marker for admin packets.
 };
@@ -86,6 +91,8 @@ enum AdminUpdateType {
 	ADMIN_UPDATE_CMD_NAMES,       ///< The admin would like a list of all DoCommand names.
 	ADMIN_UPDATE_CMD_LOGGING,     ///< The admin would like to have DoCommand information.
 	ADMIN_UPDATE_GAMESCRIPT,      ///< The admin would like to have gamescript messages.
+	ADMIN_UPDATE_TICK_PROFILE,    ///< The admin would like to have the durations of the phases of the game loop.
+	ADMIN_UPDATE_SERVER_HEALTH,   ///< The admin would like to have an overview of the performance of the server.
 	ADMIN_UPDATE_END,             ///< Must ALWAYS be on the end of this list!! (period)
 };
 
@@ -101,6 +108,28 @@ enum AdminUpdateFrequency {
 };
 DECLARE_ENUM_AS_BIT_SET(AdminUpdateFrequency)
 
+/** Fields of the economy of a company, as numbered in #ADMIN_PACKET_SERVER_COMPANY_DELTA. */
+enum AdminCompanyEconomyField {
+	ADMIN_CEF_MONEY,                    ///< Money.
+	ADMIN_CEF_LOAN,                     ///< Loan.
+	ADMIN_CEF_INCOME,                   ///< Income of this year.
+	ADMIN_CEF_DELIVERED_CARGO,          ///< Cargo delivered this quarter.
+	ADMIN_CEF_LAST_VALUE,               ///< Company value of the last quarter.
+	ADMIN_CEF_LAST_PERFORMANCE,         ///< Performance of the last quarter.
+	ADMIN_CEF_LAST_DELIVERED_CARGO,     ///< Cargo delivered in the last quarter.
+	ADMIN_CEF_PREVIOUS_VALUE,           ///< Company value of the quarter before the last.
+	ADMIN_CEF_PREVIOUS_PERFORMANCE,     ///< Performance of the quarter before the last.
+	ADMIN_CEF_PREVIOUS_DELIVERED_CARGO, ///< Cargo delivered in the quarter before the last.
+	ADMIN_CEF_END,                      ///< Must ALWAYS be on the end of this list!! (period)
+};
+
+/** Fields of the statistics of a company, as numbered in #ADMIN_PACKET_SERVER_COMPANY_DELTA. */
+enum AdminCompanyStatsField {
+	ADMIN_CSF_VEHICLES = 0,                   ///< Number of vehicles of the first #NetworkVehicleType; one field for each type.
+	ADMIN_CSF_STATIONS = NETWORK_VEH_END,     ///< Number of stations of the first #NetworkVehicleType; one field for each type.
+	ADMIN_CSF_END      = 2 * NETWORK_VEH_END, ///< Must ALWAYS be on the end of this list!! (period)
+};
+
 /** Reasons for removing a company - communicated to admins. */
 enum AdminCompanyRemoveReason {
 	ADMIN_CRR_MANUAL,    ///< The company is manually removed.
@@ -191,6 +220,19 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_ADMIN_PING(Packet *p);
 
+	/**
+	 * Choose which companies and fields are sent for #ADMIN_UPDATE_COMPANY_ECONOMY or #ADMIN_UPDATE_COMPANY_STATS;
+	 * by default all companies in full packets:
+	 * uint16  Update type, #ADMIN_UPDATE_COMPANY_ECONOMY or #ADMIN_UPDATE_COMPANY_STATS.
+	 * uint16  Bitmask of the IDs of the companies to send.
+	 * uint32  Bitmask of the fields to send (see #AdminCompanyEconomyField and #AdminCompanyStatsField); only used for delta packets.
+	 * bool    Whether to send #ADMIN_PACKET_SERVER_COMPANY_DELTA with only the changed fields, instead of the full packets.
+	 * Registering #ADMIN_FREQUENCY_AUTOMATIC for these update types always results in delta packets.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_ADMIN_COMPANY_FILTER(Packet *p);
+
 	/**
 	 * The server is full (connection gets closed).
 	 * @param p The packet that was just received.
@@ -481,6 +523,72 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_RCON_END(Packet *p);
 
+	/**
+	 * Durations of the phases of the game loop over the last ticks, in microseconds.
+	 * These fields are repeated for every phase (see #TickPhase):
+	 * bool    Data to follow.
+	 * uint8   ID of the phase.
+	 * string  Name of the phase.
+	 * uint32  Average duration since the profile was last reset.
+	 * uint32  Median duration.
+	 * uint32  95th percentile of the duration.
+	 * uint32  99th percentile of the duration.
+	 * uint32  Maximum duration.
+	 * uint16  Number of ticks per histogram bucket, repeated for all buckets (see #TICK_HISTOGRAM_BUCKETS).
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_TICK_PROFILE(Packet *p);
+
+	/**
+	 * The fields of the economy or statistics of a company that changed since they were last sent
+	 * to this admin; all subscribed fields the first time a company is sent:
+	 * uint16  Update type, #ADMIN_UPDATE_COMPANY_ECONOMY or #ADMIN_UPDATE_COMPANY_STATS.
+	 * uint8   ID of the company.
+	 * uint32  Bitmask of the fields that follow (see #AdminCompanyEconomyField and #AdminCompanyStatsField).
+	 * uint64  Value of each field in the bitmask, from the lowest bit to the highest; money is signed.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_COMPANY_DELTA(Packet *p);
+
+	/**
+	 * An overview of the performance of the server. The general fields are:
+	 * uint32  Frame counter.
+	 * uint32  Average duration of a tick since the profile was last reset, in microseconds.
+	 * uint32  Median duration of a tick over the last ticks.
+	 * uint32  95th percentile of the duration of a tick.
+	 * uint32  99th percentile of the duration of a tick.
+	 * uint32  Maximum duration of a tick.
+	 * uint16  Number of link graphs waiting for a job to be spawned.
+	 * uint16  Number of link graph jobs that are running.
+	 * uint16  Number of client connections; each gets an #ADMIN_PACKET_SERVER_CLIENT_HEALTH.
+	 * Followed by these fields, repeated for every pool:
+	 * bool    Data to follow.
+	 * string  Name of the pool.
+	 * uint32  Number of items in the pool.
+	 * uint32  Index from which all items are free.
+	 * uint32  Maximum number of items.
+	 * Should the pools not fit in one packet, more packets with the general
+	 * fields and the remaining pools follow.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_HEALTH(Packet *p);
+
+	/**
+	 * The performance of the connection to a client:
+	 * uint32  ID of the client.
+	 * uint8   Status of the connection.
+	 * uint32  Number of frames the client is behind the server.
+	 * uint16  Number of commands of the client waiting to be handled.
+	 * uint16  Number of commands waiting to be sent to the client.
+	 * uint64  Number of bytes sent to the client.
+	 * @param p The packet that was just received.
+	 * @return The state the network should have.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_CLIENT_HEALTH(Packet *p);
+
 	NetworkRecvStatus HandlePacket(Packet *p);
 public:
 	NetworkRecvStatus CloseConnection(bool error = true);
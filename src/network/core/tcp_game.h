@@ -123,9 +123,18 @@ enum PacketGameType {
 	PACKET_CLIENT_ERROR,                 ///< A client reports an error to the server.
 	PACKET_SERVER_ERROR_QUIT,            ///< A server tells that a client has hit an error and did quit.
 
+	/* Protocol extensions; only sent to clients that told they support them. */
+	PACKET_SERVER_COMMANDS,              ///< Server distributes all commands of a frame in one go.
+
 	PACKET_END,                          ///< Must ALWAYS be on the end of this list!! (period)
 };
 
+/** Optional features of the protocol a client tells the server it supports when joining. */
+enum NetworkClientFeatures {
+	NCF_NONE             = 0,      ///< Only the base protocol.
+	NCF_COMPACT_COMMANDS = 1 << 0, ///< The client understands #PACKET_SERVER_COMMANDS.
+};
+
 /** Packet that wraps a command */
 struct CommandPacket;
 
@@ -175,6 +184,7 @@ protected:
 	 * string  Name of the client (max NETWORK_NAME_LENGTH).
 	 * uint8   ID of the company to play as (1..MAX_COMPANIES).
 	 * uint8   ID of the clients Language.
+	 * uint8   Optional features the client supports (see #NetworkClientFeatures); absent for older clients.
 	 * @param p The packet that was just received.
 	 */
 	virtual NetworkRecvStatus Receive_CLIENT_JOIN(Packet *p);
@@ -377,6 +387,22 @@ protected:
 	 */
 	virtual NetworkRecvStatus Receive_SERVER_COMMAND(Packet *p);
 
+	/**
+	 * Sends all DoCommands the client has to execute in a compact form; repeated until the end of the packet:
+	 * uint8   Flags telling which fields follow (see #CompactCommandFlags).
+	 * varint  Frame of execution, relative to the previous command.
+	 * uint8   ID of the company, unless it is the same as for the previous command.
+	 * varint  ID of the command, unless it is the same as for the previous command.
+	 * varint  P1.
+	 * varint  P2.
+	 * varint  Tile, relative to the tile of the previous command (zigzag encoded).
+	 * string  Text, if there is any.
+	 * uint8   ID of the callback, if there is any.
+	 * The first command is relative to a command for company 0 and command 0 at tile 0 in frame 0.
+	 * @param p The packet that was just received.
+	 */
+	virtual NetworkRecvStatus Receive_SERVER_COMMANDS(Packet *p);
+
 	/**
 	 * Sends a chat-packet to the server:
 	 * uint8   ID of the action (see NetworkAction).
@@ -556,6 +582,8 @@ public:
 
 	const char *ReceiveCommand(Packet *p, CommandPacket *cp);
 	void SendCommand(Packet *p, const CommandPacket *cp);
+	const char *ReceiveCompactCommand(Packet *p, CommandPacket *cp, const CommandPacket *prev);
+	void SendCompactCommand(Packet *p, const CommandPacket *cp, const CommandPacket *prev);
 };
 
 #endif /* ENABLE_NETWORK */
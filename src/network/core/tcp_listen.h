@@ -32,6 +32,59 @@ template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet>
 class TCPListenHandler {
 	/** List of sockets we listen on. */
 	static SocketList sockets;
+#ifdef WITH_EPOLL
+	/** Event poll of the listening and accepted sockets, or -1 when select() is used. */
+	static int epoll;
+
+	/**
+	 * Handle the receiving of packets using the event poll. The events are
+	 * edge-triggered, so a socket is only touched after the OS reported
+	 * it became readable or writable, until it would block again.
+	 * @return true if everything went okay.
+	 */
+	static bool ReceiveEpoll()
+	{
+		struct epoll_event events[64];
+		int n;
+		do {
+			n = epoll_wait(epoll, events, lengthof(events), 0); // don't block at all.
+			if (n < 0) return errno == EINTR ? _networking : false;
+
+			bool accept = false;
+			for (int i = 0; i < n; i++) {
+				Tsocket *cs = (Tsocket *)events[i].data.ptr;
+				if (cs == NULL) {
+					accept = true;
+					continue;
+				}
+				if (events[i].events & EPOLLOUT) cs->writable = true;
+				if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) cs->readable = true;
+			}
+
+			/* accept clients.. */
+			if (accept) {
+				for (SocketList::iterator s = sockets.Begin(); s != sockets.End(); s++) AcceptClient(s->second);
+			}
+		} while (n == lengthof(events));
+
+		/* read stuff from clients */
+		Tsocket *cs;
+		FOR_ALL_ITEMS_FROM(Tsocket, idx, cs, 0) {
+			if (!cs->polled && cs->IsConnected()) {
+				/* Newly accepted; we might have missed its first events, so just
+				 * try. When it cannot be added, we keep on trying every frame. */
+				struct epoll_event ev;
+				ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+				ev.data.ptr = cs;
+				cs->polled = epoll_ctl(epoll, EPOLL_CTL_ADD, cs->sock, &ev) == 0;
+				cs->readable = true;
+				cs->writable = true;
+			}
+			if (cs->readable) cs->ReceivePackets();
+		}
+		return _networking;
+	}
+#endif /* WITH_EPOLL */
 
 public:
 	/**
@@ -99,6 +152,10 @@ public:
 	 */
 	static bool Receive()
 	{
+#ifdef WITH_EPOLL
+		if (epoll != -1) return ReceiveEpoll();
+#endif
+
 		fd_set read_fd, write_fd;
 		struct timeval tv;
 
@@ -132,7 +189,8 @@ public:
 		/* read stuff from clients */
 		FOR_ALL_ITEMS_FROM(Tsocket, idx, cs, 0) {
 			cs->writable = !!FD_ISSET(cs->sock, &write_fd);
-			if (FD_ISSET(cs->sock, &read_fd)) {
+			cs->readable = !!FD_ISSET(cs->sock, &read_fd);
+			if (cs->readable) {
 				cs->ReceivePackets();
 			}
 		}
@@ -161,6 +219,26 @@ public:
 			return false;
 		}
 
+#ifdef WITH_EPOLL
+		epoll = epoll_create(sockets.Length());
+		if (epoll < 0) {
+			DEBUG(net, 0, "[%s] could not create event poll, using select()", Tsocket::GetName());
+			return true;
+		}
+
+		for (SocketList::iterator s = sockets.Begin(); s != sockets.End(); s++) {
+			struct epoll_event ev;
+			ev.events = EPOLLIN | EPOLLET;
+			ev.data.ptr = NULL;
+			if (epoll_ctl(epoll, EPOLL_CTL_ADD, s->second, &ev) < 0) {
+				DEBUG(net, 0, "[%s] adding listener to event poll failed, using select()", Tsocket::GetName());
+				close(epoll);
+				epoll = -1;
+				break;
+			}
+		}
+#endif
+
 		return true;
 	}
 
@@ -171,11 +249,38 @@ public:
 			closesocket(s->second);
 		}
 		sockets.Clear();
+#ifdef WITH_EPOLL
+		if (epoll != -1) {
+			close(epoll);
+			epoll = -1;
+
+			Tsocket *cs;
+			FOR_ALL_ITEMS_FROM(Tsocket, idx, cs, 0) cs->polled = false;
+		}
+#endif
 		DEBUG(net, 1, "[%s] closed listeners", Tsocket::GetName());
 	}
+
+	/**
+	 * Close the descriptors of the sockets we're listening on, and of the
+	 * event poll, in a forked process. Nothing else is touched, as the
+	 * parent process keeps on listening.
+	 */
+	static void CloseInheritedListeners()
+	{
+		for (SocketList::iterator s = sockets.Begin(); s != sockets.End(); s++) {
+			closesocket(s->second);
+		}
+#ifdef WITH_EPOLL
+		if (epoll != -1) close(epoll);
+#endif
+	}
 };
 
 template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> SocketList TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::sockets;
+#ifdef WITH_EPOLL
+template <class Tsocket, PacketType Tfull_packet, PacketType Tban_packet> int TCPListenHandler<Tsocket, Tfull_packet, Tban_packet>::epoll = -1;
+#endif
 
 #endif /* ENABLE_NETWORK */
 
@@ -549,6 +549,27 @@ void NetworkClose(bool close_admins)
 	InitializeNetworkPools(close_admins);
 }
 
+/**
+ * Close the descriptors of all sockets in a process that has been forked
+ * from the game, like the one writing an autosave snapshot. Nothing is
+ * sent, logged or freed, as the game keeps using the connections.
+ */
+void NetworkCloseInheritedSockets()
+{
+	NetworkClientSocket *cs;
+	FOR_ALL_CLIENT_SOCKETS(cs) cs->CloseInheritedSocket();
+
+	ServerNetworkAdminSocketHandler *as;
+	FOR_ALL_ADMIN_SOCKETS(as) as->CloseInheritedSocket();
+
+	ServerNetworkGameSocketHandler::CloseInheritedListeners();
+	ServerNetworkAdminSocketHandler::CloseInheritedListeners();
+
+	if (MyClient::my_client != NULL) MyClient::my_client->CloseInheritedSocket();
+	_network_content_client.CloseInheritedSocket();
+	NetworkUDPCloseInheritedSockets();
+}
+
 /* Initializes the network (cleans sockets and stuff) */
 static void NetworkInitialize(bool close_admins = true)
 {
@@ -829,6 +850,8 @@ static bool NetworkReceive()
 /* This sends all buffered commands (if possible) */
 static void NetworkSend()
 {
+	_network_tcp_send_stats.frames++;
+
 	if (_network_server) {
 		ServerNetworkAdminSocketHandler::Send();
 		ServerNetworkGameSocketHandler::Send();
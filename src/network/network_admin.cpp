@@ -24,6 +24,8 @@
 #include "../map_func.h"
 #include "../rev.h"
 #include "../game/game.hpp"
+#include "../tick_profiler.h"
+#include "../linkgraph/linkgraphschedule.h"
 
 
 /* This file handles all the admin network commands. */
@@ -47,16 +49,22 @@ static const AdminUpdateFrequency _admin_update_type_frequencies[] = {
 	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_DATE
 	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CLIENT_INFO
 	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_COMPANY_INFO
-	ADMIN_FREQUENCY_POLL |                         ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_COMPANY_ECONOMY
-	ADMIN_FREQUENCY_POLL |                         ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_COMPANY_STATS
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY | ADMIN_FREQUENCY_AUTOMATIC, ///< ADMIN_UPDATE_COMPANY_ECONOMY
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY | ADMIN_FREQUENCY_AUTOMATIC, ///< ADMIN_UPDATE_COMPANY_STATS
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CHAT
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CONSOLE
 	ADMIN_FREQUENCY_POLL,                                                                                                                                  ///< ADMIN_UPDATE_CMD_NAMES
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_CMD_LOGGING
 	                       ADMIN_FREQUENCY_AUTOMATIC,                                                                                                      ///< ADMIN_UPDATE_GAMESCRIPT
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_TICK_PROFILE
+	ADMIN_FREQUENCY_POLL | ADMIN_FREQUENCY_DAILY | ADMIN_FREQUENCY_WEEKLY | ADMIN_FREQUENCY_MONTHLY | ADMIN_FREQUENCY_QUARTERLY | ADMIN_FREQUENCY_ANUALLY, ///< ADMIN_UPDATE_SERVER_HEALTH
 };
 /** Sanity check. */
 assert_compile(lengthof(_admin_update_type_frequencies) == ADMIN_UPDATE_END);
+assert_compile((int)ADMIN_CSF_END <= (int)ADMIN_CEF_END && ADMIN_CEF_END <= 32);
+
+/** Number of ticks between checks for changes in the economy and statistics of companies for #ADMIN_FREQUENCY_AUTOMATIC. */
+static const uint ADMIN_COMPANY_CHANGES_INTERVAL = 8;
 
 /**
  * Create a new socket for the server side of the admin network.
@@ -67,6 +75,10 @@ ServerNetworkAdminSocketHandler::ServerNetworkAdminSocketHandler(SOCKET s) : Net
 	_network_admins_connected++;
 	this->status = ADMIN_STATUS_INACTIVE;
 	this->realtime_connect = _realtime_tick;
+
+	/* By default all companies are sent in full. */
+	this->economy_filter.companies = this->stats_filter.companies = UINT16_MAX;
+	this->economy_filter.fields = this->stats_filter.fields = UINT32_MAX;
 }
 
 /**
@@ -398,15 +410,50 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyRemove(CompanyID c
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Send economic information of all companies. */
-NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyEconomy()
+/**
+ * Get the fields of the economy of a company, as numbered by #AdminCompanyEconomyField.
+ * @param company The company.
+ * @param[out] values The values of the fields.
+ */
+static void GetCompanyEconomyFields(const Company *company, uint64 values[ADMIN_CEF_END])
+{
+	/* Get the income. */
+	Money income = 0;
+	for (uint i = 0; i < lengthof(company->yearly_expenses[0]); i++) {
+		income -= company->yearly_expenses[0][i];
+	}
+
+	/* Current information. */
+	values[ADMIN_CEF_MONEY]           = (int64)company->money;
+	values[ADMIN_CEF_LOAN]            = (int64)company->current_loan;
+	values[ADMIN_CEF_INCOME]          = (int64)income;
+	values[ADMIN_CEF_DELIVERED_CARGO] = min(UINT16_MAX, company->cur_economy.delivered_cargo.GetSum<OverflowSafeInt64>());
+
+	/* Stats for the last 2 quarters. */
+	for (uint i = 0; i < 2; i++) {
+		uint offset = i * (ADMIN_CEF_PREVIOUS_VALUE - ADMIN_CEF_LAST_VALUE);
+		values[ADMIN_CEF_LAST_VALUE + offset]           = (int64)company->old_economy[i].company_value;
+		values[ADMIN_CEF_LAST_PERFORMANCE + offset]     = company->old_economy[i].performance_history;
+		values[ADMIN_CEF_LAST_DELIVERED_CARGO + offset] = min(UINT16_MAX, company->old_economy[i].delivered_cargo.GetSum<OverflowSafeInt64>());
+	}
+}
+
+/**
+ * Send economic information of the companies the admin wants.
+ * @param delta Whether to only send the fields that changed since they were last sent.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyEconomy(bool delta)
 {
 	const Company *company;
 	FOR_ALL_COMPANIES(company) {
-		/* Get the income. */
-		Money income = 0;
-		for (uint i = 0; i < lengthof(company->yearly_expenses[0]); i++) {
-			income -= company->yearly_expenses[0][i];
+		if (!HasBit(this->economy_filter.companies, company->index)) continue;
+
+		uint64 values[ADMIN_CEF_END];
+		GetCompanyEconomyFields(company, values);
+
+		if (delta) {
+			this->SendCompanyDelta(ADMIN_UPDATE_COMPANY_ECONOMY, company->index, values, ADMIN_CEF_END);
+			continue;
 		}
 
 		Packet *p = new Packet(ADMIN_PACKET_SERVER_COMPANY_ECONOMY);
@@ -414,16 +461,16 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyEconomy()
 		p->Send_uint8(company->index);
 
 		/* Current information. */
-		p->Send_uint64(company->money);
-		p->Send_uint64(company->current_loan);
-		p->Send_uint64(income);
-		p->Send_uint16(min(UINT16_MAX, company->cur_economy.delivered_cargo.GetSum<OverflowSafeInt64>()));
+		p->Send_uint64(values[ADMIN_CEF_MONEY]);
+		p->Send_uint64(values[ADMIN_CEF_LOAN]);
+		p->Send_uint64(values[ADMIN_CEF_INCOME]);
+		p->Send_uint16((uint16)values[ADMIN_CEF_DELIVERED_CARGO]);
 
 		/* Send stats for the last 2 quarters. */
-		for (uint i = 0; i < 2; i++) {
-			p->Send_uint64(company->old_economy[i].company_value);
-			p->Send_uint16(company->old_economy[i].performance_history);
-			p->Send_uint16(min(UINT16_MAX, company->old_economy[i].delivered_cargo.GetSum<OverflowSafeInt64>()));
+		for (uint i = ADMIN_CEF_LAST_VALUE; i < ADMIN_CEF_END; i += 3) {
+			p->Send_uint64(values[i]);
+			p->Send_uint16((uint16)values[i + 1]);
+			p->Send_uint16((uint16)values[i + 2]);
 		}
 
 		this->SendPacket(p);
@@ -433,17 +480,36 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyEconomy()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
-/** Send statistics about the companies. */
-NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats()
+/**
+ * Send statistics about the companies the admin wants.
+ * @param delta Whether to only send the fields that changed since they were last sent.
+ * @param company_stats The statistics of all companies, or \c NULL to determine them.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats(bool delta, const NetworkCompanyStats *company_stats)
 {
 	/* Fetch the latest version of the stats. */
-	NetworkCompanyStats company_stats[MAX_COMPANIES];
-	NetworkPopulateCompanyStats(company_stats);
+	NetworkCompanyStats stats[MAX_COMPANIES];
+	if (company_stats == NULL) {
+		NetworkPopulateCompanyStats(stats);
+		company_stats = stats;
+	}
 
 	const Company *company;
 
 	/* Go through all the companies. */
 	FOR_ALL_COMPANIES(company) {
+		if (!HasBit(this->stats_filter.companies, company->index)) continue;
+
+		if (delta) {
+			uint64 values[ADMIN_CSF_END];
+			for (uint i = 0; i < NETWORK_VEH_END; i++) {
+				values[ADMIN_CSF_VEHICLES + i] = company_stats[company->index].num_vehicle[i];
+				values[ADMIN_CSF_STATIONS + i] = company_stats[company->index].num_station[i];
+			}
+			this->SendCompanyDelta(ADMIN_UPDATE_COMPANY_STATS, company->index, values, ADMIN_CSF_END);
+			continue;
+		}
+
 		Packet *p = new Packet(ADMIN_PACKET_SERVER_COMPANY_STATS);
 
 		/* Send the information. */
@@ -463,6 +529,43 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyStats()
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send the fields of the economy or statistics of a company that changed since
+ * they were last sent, or all subscribed fields when none were sent before.
+ * @param type The update type, #ADMIN_UPDATE_COMPANY_ECONOMY or #ADMIN_UPDATE_COMPANY_STATS.
+ * @param company_id The company.
+ * @param values The current values of the fields.
+ * @param count The number of fields.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCompanyDelta(AdminUpdateType type, CompanyID company_id, const uint64 *values, uint count)
+{
+	AdminCompanyFilter &filter = type == ADMIN_UPDATE_COMPANY_STATS ? this->stats_filter : this->economy_filter;
+	uint64 *sent = filter.values[company_id];
+	bool known = HasBit(filter.known, company_id);
+
+	uint32 changed = 0;
+	for (uint i = 0; i < count; i++) {
+		if (HasBit(filter.fields, i) && (!known || sent[i] != values[i])) SetBit(changed, i);
+	}
+	SetBit(filter.known, company_id);
+	if (changed == 0) return NETWORK_RECV_STATUS_OKAY;
+
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_COMPANY_DELTA);
+	p->Send_uint16(type);
+	p->Send_uint8(company_id);
+	p->Send_uint32(changed);
+
+	uint i;
+	FOR_EACH_SET_BIT(i, changed) {
+		p->Send_uint64(values[i]);
+		sent[i] = values[i];
+	}
+
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -661,6 +764,131 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::SendCmdLogging(ClientID clien
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/** Send the durations of the phases of the game loop. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendTickProfile()
+{
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_TICK_PROFILE);
+
+	for (uint i = 0; i < TP_END; i++) {
+		const TickPhaseHistory &h = _tick_profile[i];
+		const char *name = GetTickPhaseName((TickPhase)i);
+
+		/* Should SEND_MTU be exceeded, start a new packet
+		 * (magic 4: 1 bool "more data", one uint8 "phase id", one
+		 * byte for string '\0' termination and 1 bool "no more data"),
+		 * next to the five durations and the histogram. */
+		if (p->size + strlen(name) + 4 + 5 * sizeof(uint32) + TICK_HISTOGRAM_BUCKETS * sizeof(uint16) >= SEND_MTU) {
+			p->Send_bool(false);
+			this->SendPacket(p);
+
+			p = new Packet(ADMIN_PACKET_SERVER_TICK_PROFILE);
+		}
+
+		p->Send_bool(true);
+		p->Send_uint8(i);
+		p->Send_string(name);
+		p->Send_uint32(h.GetAverage());
+		p->Send_uint32(h.GetPercentile(50));
+		p->Send_uint32(h.GetPercentile(95));
+		p->Send_uint32(h.GetPercentile(99));
+		p->Send_uint32(h.GetPercentile(100));
+
+		uint16 buckets[TICK_HISTOGRAM_BUCKETS];
+		h.GetHistogram(buckets);
+		for (uint j = 0; j < TICK_HISTOGRAM_BUCKETS; j++) {
+			p->Send_uint16(buckets[j]);
+		}
+	}
+
+	/* Marker to notify the end of the packet has been reached. */
+	p->Send_bool(false);
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Write the general fields of the health of the server to a packet.
+ * @param p The packet to write to.
+ */
+static void SendHealthHeader(Packet *p)
+{
+	const TickPhaseHistory &h = _tick_profile[TP_TOTAL];
+	const LinkGraphSchedule *lgs = LinkGraphSchedule::Instance();
+
+	p->Send_uint32(_frame_counter);
+	p->Send_uint32(h.GetAverage());
+	p->Send_uint32(h.GetPercentile(50));
+	p->Send_uint32(h.GetPercentile(95));
+	p->Send_uint32(h.GetPercentile(99));
+	p->Send_uint32(h.GetPercentile(100));
+	p->Send_uint16(min<uint>(lgs->GetQueuedCount(), UINT16_MAX));
+	p->Send_uint16(min<uint>(lgs->GetRunningCount(), UINT16_MAX));
+	p->Send_uint16((uint16)NetworkClientSocket::GetNumItems());
+}
+
+/** Send an overview of the performance of the server, followed by the health of the connection to each client. */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendHealth()
+{
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_HEALTH);
+	SendHealthHeader(p);
+
+	const PoolVector *pools = PoolBase::GetPools();
+	for (uint i = 0; i < pools->Length(); i++) {
+		PoolStats stats;
+		(*pools)[i]->GetStats(&stats);
+
+		/* Should SEND_MTU be exceeded, start a new packet
+		 * (magic 3: 1 bool "more data", one byte for string
+		 * '\0' termination and 1 bool "no more data"),
+		 * next to the three counts. */
+		if (p->size + strlen(stats.name) + 3 + 3 * sizeof(uint32) >= SEND_MTU) {
+			p->Send_bool(false);
+			this->SendPacket(p);
+
+			p = new Packet(ADMIN_PACKET_SERVER_HEALTH);
+			SendHealthHeader(p);
+		}
+
+		p->Send_bool(true);
+		p->Send_string(stats.name);
+		p->Send_uint32((uint32)stats.items);
+		p->Send_uint32((uint32)stats.first_unused);
+		p->Send_uint32((uint32)stats.max_size);
+	}
+
+	/* Marker to notify the end of the packet has been reached. */
+	p->Send_bool(false);
+	this->SendPacket(p);
+
+	NetworkClientSocket *cs;
+	FOR_ALL_CLIENT_SOCKETS(cs) {
+		this->SendClientHealth(cs);
+	}
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
+/**
+ * Send the performance of the connection to a client.
+ * @param cs The socket of the client.
+ */
+NetworkRecvStatus ServerNetworkAdminSocketHandler::SendClientHealth(const NetworkClientSocket *cs)
+{
+	Packet *p = new Packet(ADMIN_PACKET_SERVER_CLIENT_HEALTH);
+
+	p->Send_uint32(cs->client_id);
+	p->Send_uint8 (cs->status);
+	p->Send_uint32(cs->status == NetworkClientSocket::STATUS_ACTIVE ? NetworkCalculateLag(cs) : 0);
+	p->Send_uint16(min<uint>(cs->incoming_queue.Count(), UINT16_MAX));
+	p->Send_uint16(min<uint>(cs->outgoing_queue.Count(), UINT16_MAX));
+	p->Send_uint64(cs->bytes_sent);
+
+	this->SendPacket(p);
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /***********
  * Receiving functions
  ************/
@@ -717,6 +945,27 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_UPDATE_FREQUENC
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_COMPANY_FILTER(Packet *p)
+{
+	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
+
+	AdminUpdateType type = (AdminUpdateType)p->Recv_uint16();
+	if (type != ADMIN_UPDATE_COMPANY_ECONOMY && type != ADMIN_UPDATE_COMPANY_STATS) {
+		DEBUG(net, 3, "[admin] Not supported company filter %d from '%s' (%s).", type, this->admin_name, this->admin_version);
+		return this->SendError(NETWORK_ERROR_ILLEGAL_PACKET);
+	}
+
+	AdminCompanyFilter &filter = type == ADMIN_UPDATE_COMPANY_STATS ? this->stats_filter : this->economy_filter;
+	filter.companies = p->Recv_uint16();
+	filter.fields    = p->Recv_uint32();
+	filter.delta     = p->Recv_bool();
+
+	/* Make sure the next delta contains everything the admin now wants. */
+	filter.known = 0;
+
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 {
 	if (this->status == ADMIN_STATUS_INACTIVE) return this->SendError(NETWORK_ERROR_NOT_EXPECTED);
@@ -763,12 +1012,12 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 
 		case ADMIN_UPDATE_COMPANY_ECONOMY:
 			/* The admin is requesting economy info. */
-			this->SendCompanyEconomy();
+			this->SendCompanyEconomy(this->economy_filter.delta);
 			break;
 
 		case ADMIN_UPDATE_COMPANY_STATS:
 			/* the admin is requesting company stats. */
-			this->SendCompanyStats();
+			this->SendCompanyStats(this->stats_filter.delta);
 			break;
 
 		case ADMIN_UPDATE_CMD_NAMES:
@@ -776,6 +1025,16 @@ NetworkRecvStatus ServerNetworkAdminSocketHandler::Receive_ADMIN_POLL(Packet *p)
 			this->SendCmdNames();
 			break;
 
+		case ADMIN_UPDATE_TICK_PROFILE:
+			/* The admin is requesting the durations of the game loop phases. */
+			this->SendTickProfile();
+			break;
+
+		case ADMIN_UPDATE_SERVER_HEALTH:
+			/* The admin is requesting the performance of the server. */
+			this->SendHealth();
+			break;
+
 		default:
 			/* An unsupported "poll" update type. */
 			DEBUG(net, 3, "[admin] Not supported poll %d (%d) from '%s' (%s).", type, d1, this->admin_name, this->admin_version);
@@ -891,6 +1150,12 @@ void NetworkAdminCompanyInfo(const Company *company, bool new_company)
 
 	ServerNetworkAdminSocketHandler *as;
 	FOR_ALL_ACTIVE_ADMIN_SOCKETS(as) {
+		if (new_company) {
+			/* Whatever was sent for a previous company with this ID is meaningless now. */
+			ClrBit(as->economy_filter.known, company->index);
+			ClrBit(as->stats_filter.known, company->index);
+		}
+
 		if (as->update_frequency[ADMIN_UPDATE_COMPANY_INFO] != ADMIN_FREQUENCY_AUTOMATIC) continue;
 
 		as->SendCompanyInfo(company);
@@ -925,6 +1190,8 @@ void NetworkAdminCompanyRemove(CompanyID company_id, AdminCompanyRemoveReason bc
 {
 	ServerNetworkAdminSocketHandler *as;
 	FOR_ALL_ACTIVE_ADMIN_SOCKETS(as) {
+		ClrBit(as->economy_filter.known, company_id);
+		ClrBit(as->stats_filter.known, company_id);
 		as->SendCompanyRemove(company_id, bcrr);
 	}
 }
@@ -1030,11 +1297,19 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 						break;
 
 					case ADMIN_UPDATE_COMPANY_ECONOMY:
-						as->SendCompanyEconomy();
+						as->SendCompanyEconomy(as->economy_filter.delta);
 						break;
 
 					case ADMIN_UPDATE_COMPANY_STATS:
-						as->SendCompanyStats();
+						as->SendCompanyStats(as->stats_filter.delta);
+						break;
+
+					case ADMIN_UPDATE_TICK_PROFILE:
+						as->SendTickProfile();
+						break;
+
+					case ADMIN_UPDATE_SERVER_HEALTH:
+						as->SendHealth();
 						break;
 
 					default: NOT_REACHED();
@@ -1044,4 +1319,32 @@ void NetworkAdminUpdate(AdminUpdateFrequency freq)
 	}
 }
 
+/**
+ * Send the changes in the economy and statistics of companies to the admins that
+ * asked for them automatically. Called every tick; checks every few ticks.
+ */
+void NetworkAdminCompanyChanges()
+{
+	if (_network_admins_connected == 0 || _frame_counter % ADMIN_COMPANY_CHANGES_INTERVAL != 0) return;
+
+	/* Determining the statistics walks all vehicles and stations, so do it once for all admins. */
+	NetworkCompanyStats company_stats[MAX_COMPANIES];
+	bool have_stats = false;
+
+	ServerNetworkAdminSocketHandler *as;
+	FOR_ALL_ACTIVE_ADMIN_SOCKETS(as) {
+		if (as->update_frequency[ADMIN_UPDATE_COMPANY_ECONOMY] & ADMIN_FREQUENCY_AUTOMATIC) {
+			as->SendCompanyEconomy(true);
+		}
+
+		if (as->update_frequency[ADMIN_UPDATE_COMPANY_STATS] & ADMIN_FREQUENCY_AUTOMATIC) {
+			if (!have_stats) {
+				NetworkPopulateCompanyStats(company_stats);
+				have_stats = true;
+			}
+			as->SendCompanyStats(true, company_stats);
+		}
+	}
+}
+
 #endif /* ENABLE_NETWORK */
@@ -20,6 +20,15 @@
 
 extern AdminIndex _redirect_console_to_admin;
 
+/** The companies and fields of the economy or statistics an admin wants, and what it got last. */
+struct AdminCompanyFilter {
+	uint16 companies;                            ///< Bitmask of the companies to send.
+	uint32 fields;                               ///< Bitmask of the fields to send in delta packets.
+	bool delta;                                  ///< Whether to send only the changed fields, also for the periodic updates.
+	uint16 known;                                ///< Bitmask of the companies of which #values holds what the admin got.
+	uint64 values[MAX_COMPANIES][ADMIN_CEF_END]; ///< The values of the fields that were sent last; there are no more statistics fields.
+};
+
 class ServerNetworkAdminSocketHandler;
 /** Pool with all admin connections. */
 typedef Pool<ServerNetworkAdminSocketHandler, AdminIndex, 2, MAX_ADMINS, PT_NADMIN> NetworkAdminSocketPool;
@@ -36,11 +45,15 @@ protected:
 	virtual NetworkRecvStatus Receive_ADMIN_RCON(Packet *p);
 	virtual NetworkRecvStatus Receive_ADMIN_GAMESCRIPT(Packet *p);
 	virtual NetworkRecvStatus Receive_ADMIN_PING(Packet *p);
+	virtual NetworkRecvStatus Receive_ADMIN_COMPANY_FILTER(Packet *p);
 
 	NetworkRecvStatus SendProtocol();
+	NetworkRecvStatus SendCompanyDelta(AdminUpdateType type, CompanyID company_id, const uint64 *values, uint count);
 	NetworkRecvStatus SendPong(uint32 d1);
 public:
 	AdminUpdateFrequency update_frequency[ADMIN_UPDATE_END]; ///< Admin requested update intervals.
+	AdminCompanyFilter economy_filter;                       ///< What to send for #ADMIN_UPDATE_COMPANY_ECONOMY.
+	AdminCompanyFilter stats_filter;                         ///< What to send for #ADMIN_UPDATE_COMPANY_STATS.
 	uint32 realtime_connect;                                 ///< Time of connection.
 	NetworkAddress address;                                  ///< Address of the admin.
 
@@ -62,8 +75,8 @@ public:
 	NetworkRecvStatus SendCompanyInfo(const Company *c);
 	NetworkRecvStatus SendCompanyUpdate(const Company *c);
 	NetworkRecvStatus SendCompanyRemove(CompanyID company_id, AdminCompanyRemoveReason bcrr);
-	NetworkRecvStatus SendCompanyEconomy();
-	NetworkRecvStatus SendCompanyStats();
+	NetworkRecvStatus SendCompanyEconomy(bool delta = false);
+	NetworkRecvStatus SendCompanyStats(bool delta = false, const NetworkCompanyStats *company_stats = NULL);
 
 	NetworkRecvStatus SendChat(NetworkAction action, DestType desttype, ClientID client_id, const char *msg, int64 data);
 	NetworkRecvStatus SendRcon(uint16 colour, const char *command);
@@ -72,6 +85,9 @@ public:
 	NetworkRecvStatus SendCmdNames();
 	NetworkRecvStatus SendCmdLogging(ClientID client_id, const CommandPacket *cp);
 	NetworkRecvStatus SendRconEnd(const char *command);
+	NetworkRecvStatus SendTickProfile();
+	NetworkRecvStatus SendHealth();
+	NetworkRecvStatus SendClientHealth(const NetworkClientSocket *cs);
 
 	static void Send();
 	static void AcceptConnection(SOCKET s, const NetworkAddress &address);
@@ -119,6 +135,7 @@ void NetworkAdminCompanyRemove(CompanyID company_id, AdminCompanyRemoveReason bc
 
 void NetworkAdminChat(NetworkAction action, DestType desttype, ClientID client_id, const char *msg, int64 data = 0, bool from_admin = false);
 void NetworkAdminUpdate(AdminUpdateFrequency freq);
+void NetworkAdminCompanyChanges();
 void NetworkServerSendAdminRcon(AdminIndex admin_index, TextColour colour_code, const char *string);
 void NetworkAdminConsole(const char *origin, const char *string);
 void NetworkAdminGameScript(const char *json);
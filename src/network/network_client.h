@@ -42,6 +42,7 @@ private:
 protected:
 	friend void NetworkExecuteLocalCommandQueue();
 	friend void NetworkClose(bool close_admins);
+	friend void NetworkCloseInheritedSockets();
 	static ClientNetworkGameSocketHandler *my_client; ///< This is us!
 
 	virtual NetworkRecvStatus Receive_SERVER_FULL(Packet *p);
@@ -61,6 +62,7 @@ protected:
 	virtual NetworkRecvStatus Receive_SERVER_FRAME(Packet *p);
 	virtual NetworkRecvStatus Receive_SERVER_SYNC(Packet *p);
 	virtual NetworkRecvStatus Receive_SERVER_COMMAND(Packet *p);
+	virtual NetworkRecvStatus Receive_SERVER_COMMANDS(Packet *p);
 	virtual NetworkRecvStatus Receive_SERVER_CHAT(Packet *p);
 	virtual NetworkRecvStatus Receive_SERVER_QUIT(Packet *p);
 	virtual NetworkRecvStatus Receive_SERVER_ERROR_QUIT(Packet *p);
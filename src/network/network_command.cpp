@@ -317,6 +317,25 @@ const char *NetworkGameSocketHandler::ReceiveCommand(Packet *p, CommandPacket *c
 	return NULL;
 }
 
+/**
+ * Get the index of the callback of a command in the callback table.
+ * @param callback The callback to look up.
+ * @return The index, 0 (no callback) when it is unknown.
+ */
+static byte GetCallbackIndex(CommandCallback *callback)
+{
+	byte index = 0;
+	while (index < lengthof(_callback_table) && _callback_table[index] != callback) {
+		index++;
+	}
+
+	if (index == lengthof(_callback_table)) {
+		DEBUG(net, 0, "Unknown callback. (Pointer: %p) No callback sent", callback);
+		index = 0; // _callback_table[0] == NULL
+	}
+	return index;
+}
+
 /**
  * Sends a command over the network.
  * @param p the packet to send it in.
@@ -330,17 +349,104 @@ void NetworkGameSocketHandler::SendCommand(Packet *p, const CommandPacket *cp)
 	p->Send_uint32(cp->p2);
 	p->Send_uint32(cp->tile);
 	p->Send_string(cp->text);
+	p->Send_uint8 (GetCallbackIndex(cp->callback));
+}
 
-	byte callback = 0;
-	while (callback < lengthof(_callback_table) && _callback_table[callback] != cp->callback) {
-		callback++;
-	}
+/** Flags telling which fields of a compact command are sent. */
+enum CompactCommandFlags {
+	CCF_MY_CMD       = 1 << 0, ///< The command originated from the receiving client.
+	CCF_SAME_COMPANY = 1 << 1, ///< The company is the same as for the previous command.
+	CCF_SAME_COMMAND = 1 << 2, ///< The command is the same as the previous command.
+	CCF_TEXT         = 1 << 3, ///< The command has a text.
+	CCF_CALLBACK     = 1 << 4, ///< The command has a callback.
+};
+
+/**
+ * Get the command the first compact command of a packet is relative to.
+ * @param[out] base The command to fill.
+ * @return \a base.
+ */
+static const CommandPacket *GetCompactCommandBase(CommandPacket *base)
+{
+	base->company = COMPANY_FIRST;
+	base->cmd     = 0;
+	base->tile    = 0;
+	base->frame   = 0;
+	return base;
+}
+
+/**
+ * Receives a command sent with #SendCompactCommand from the network.
+ * @param p the packet to read from.
+ * @param cp the struct to write the data to, including the frame and whether it is our own command.
+ * @param prev the previous command in the packet, or \c NULL for the first.
+ * @return an error message. When NULL there has been no error.
+ */
+const char *NetworkGameSocketHandler::ReceiveCompactCommand(Packet *p, CommandPacket *cp, const CommandPacket *prev)
+{
+	CommandPacket base;
+	if (prev == NULL) prev = GetCompactCommandBase(&base);
+
+	byte flags  = p->Recv_uint8();
+	cp->my_cmd  = (flags & CCF_MY_CMD) != 0;
+	cp->frame   = prev->frame + p->Recv_varint();
+	cp->company = (flags & CCF_SAME_COMPANY) != 0 ? prev->company : (CompanyID)p->Recv_uint8();
+	cp->cmd     = (flags & CCF_SAME_COMMAND) != 0 ? prev->cmd : p->Recv_varint();
+	if (!IsValidCommand(cp->cmd))               return "invalid command";
+	if (GetCommandFlags(cp->cmd) & CMD_OFFLINE) return "offline only command";
+	if ((cp->cmd & CMD_FLAGS_MASK) != 0)        return "invalid command flag";
 
-	if (callback == lengthof(_callback_table)) {
-		DEBUG(net, 0, "Unknown callback. (Pointer: %p) No callback sent", cp->callback);
-		callback = 0; // _callback_table[0] == NULL
+	cp->p1      = p->Recv_varint();
+	cp->p2      = p->Recv_varint();
+	uint32 tile = p->Recv_varint();
+	cp->tile    = prev->tile + ((tile >> 1) ^ (0 - (tile & 1)));
+	if ((flags & CCF_TEXT) != 0) {
+		p->Recv_string(cp->text, lengthof(cp->text), (GetCommandFlags(cp->cmd) & CMD_STR_CTRL) != 0 ? SVS_ALLOW_CONTROL_CODE | SVS_REPLACE_WITH_QUESTION_MARK : SVS_REPLACE_WITH_QUESTION_MARK);
+	} else {
+		cp->text[0] = '\0';
 	}
-	p->Send_uint8 (callback);
+
+	byte callback = (flags & CCF_CALLBACK) != 0 ? p->Recv_uint8() : 0;
+	if (callback >= lengthof(_callback_table))  return "invalid callback";
+
+	cp->callback = _callback_table[callback];
+	return NULL;
+}
+
+/**
+ * Sends a command, including its frame and whether it is the receiver's
+ * own command, over the network. Only the fields that differ from the
+ * previous command are sent, and numbers take as few bytes as possible.
+ * The packet must have room for #COMPACT_COMMAND_MAX_SIZE bytes plus the text.
+ * @param p the packet to send it in.
+ * @param cp the packet to actually send.
+ * @param prev the previous command in the packet, or \c NULL for the first.
+ */
+void NetworkGameSocketHandler::SendCompactCommand(Packet *p, const CommandPacket *cp, const CommandPacket *prev)
+{
+	CommandPacket base;
+	if (prev == NULL) prev = GetCompactCommandBase(&base);
+
+	byte callback = GetCallbackIndex(cp->callback);
+
+	byte flags = 0;
+	if (cp->my_cmd)                   flags |= CCF_MY_CMD;
+	if (cp->company == prev->company) flags |= CCF_SAME_COMPANY;
+	if (cp->cmd == prev->cmd)         flags |= CCF_SAME_COMMAND;
+	if (!StrEmpty(cp->text))          flags |= CCF_TEXT;
+	if (callback != 0)                flags |= CCF_CALLBACK;
+
+	p->Send_uint8(flags);
+	p->Send_varint(cp->frame - prev->frame);
+	if ((flags & CCF_SAME_COMPANY) == 0) p->Send_uint8(cp->company);
+	if ((flags & CCF_SAME_COMMAND) == 0) p->Send_varint(cp->cmd);
+	p->Send_varint(cp->p1);
+	p->Send_varint(cp->p2);
+	/* Zigzag encode the distance, so nearby tiles in either direction take few bytes. */
+	int32 tile = (int32)(cp->tile - prev->tile);
+	p->Send_varint(((uint32)tile << 1) ^ (uint32)(tile >> 31));
+	if ((flags & CCF_TEXT) != 0) p->Send_string(cp->text);
+	if ((flags & CCF_CALLBACK) != 0) p->Send_uint8(callback);
 }
 
 #endif /* ENABLE_NETWORK */
@@ -159,6 +159,9 @@ struct CommandPacket : CommandContainer {
 	bool my_cmd;         ///< did the command originate from "me"
 };
 
+/** Upper bound of the size of a command sent with NetworkGameSocketHandler::SendCompactCommand, excluding the characters of its text. */
+static const uint COMPACT_COMMAND_MAX_SIZE = 1 + 5 + 1 + 5 + 5 + 5 + 5 + 1 + 1;
+
 void NetworkDistributeCommands();
 void NetworkExecuteLocalCommandQueue();
 void NetworkFreeLocalCommandQueue();
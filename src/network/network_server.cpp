@@ -52,164 +52,179 @@ INSTANTIATE_POOL_METHODS(NetworkClientSocket)
 /** Instantiate the listen sockets. */
 template SocketList TCPListenHandler<ServerNetworkGameSocketHandler, PACKET_SERVER_FULL, PACKET_SERVER_BANNED>::sockets;
 
-/** Writing a savegame directly to a number of packets. */
-struct PacketWriter : SaveFilter {
-	ServerNetworkGameSocketHandler *cs; ///< Socket we are associated with.
-	Packet *current;                    ///< The packet we're currently writing to.
-	size_t total_size;                  ///< Total size of the compressed savegame.
-	Packet *packets;                    ///< Packet queue of the savegame; send these "slowly" to the client.
-	ThreadMutex *mutex;                 ///< Mutex for making threaded saving safe.
+/**
+ * A compressed savegame for joining clients. All clients that request the
+ * map in the same frame share one, so the game is only saved and compressed
+ * once for them. Each client makes its own packets from it while it is
+ * being written by the saving thread.
+ */
+struct NetworkMapSnapshot {
+	static const size_t BLOCK_SIZE = 64 * 1024; ///< Size of the blocks the savegame is stored in.
+
+	uint32 frame;                          ///< The frame the game was saved in.
+	AutoFreeSmallVector<byte *, 64> blocks; ///< The blocks with the compressed savegame.
+	size_t size;                           ///< Size of the compressed savegame written so far.
+	bool finished;                         ///< Whether the whole savegame has been written.
+	bool saving;                           ///< Whether the savegame is still being written, or the writing is being aborted.
+	uint clients;                          ///< Number of clients receiving this savegame.
+	ThreadMutex *mutex;                    ///< Mutex for making threaded saving safe.
 
 	/**
-	 * Create the packet writer.
-	 * @param cs The socket handler we're making the packets for.
+	 * Create the snapshot of the current frame.
 	 */
-	PacketWriter(ServerNetworkGameSocketHandler *cs) : SaveFilter(NULL), cs(cs), current(NULL), total_size(0), packets(NULL)
+	NetworkMapSnapshot() : frame(_frame_counter), size(0), finished(false), saving(true), clients(0)
 	{
 		this->mutex = ThreadMutex::New();
 	}
 
-	/** Make sure everything is cleaned up. */
-	~PacketWriter()
-	{
-		if (this->mutex != NULL) this->mutex->BeginCritical();
+	~NetworkMapSnapshot();
 
-		if (this->cs != NULL && this->mutex != NULL) {
-			this->mutex->WaitForSignal();
-		}
-
-		/* This must all wait until the Destroy function is called. */
-
-		while (this->packets != NULL) {
-			Packet *p = this->packets->next;
-			delete this->packets;
-			this->packets = p;
+	/**
+	 * Append compressed data of the savegame; called by the saving thread.
+	 * @param buf  The data.
+	 * @param size The amount of data.
+	 * @return False when all clients left and the saving can be aborted.
+	 */
+	bool Append(const byte *buf, size_t size)
+	{
+		this->mutex->BeginCritical();
+		bool clients = this->clients != 0;
+		while (clients && size > 0) {
+			size_t offset = this->size % BLOCK_SIZE;
+			if (offset == 0) *this->blocks.Append() = MallocT<byte>(BLOCK_SIZE);
+
+			size_t to_write = min(BLOCK_SIZE - offset, size);
+			memcpy(this->blocks[this->size / BLOCK_SIZE] + offset, buf, to_write);
+			this->size += to_write;
+			buf += to_write;
+			size -= to_write;
 		}
-
-		delete this->current;
-
-		if (this->mutex != NULL) this->mutex->EndCritical();
-
-		delete this->mutex;
-		this->mutex = NULL;
+		this->mutex->EndCritical();
+		return clients;
 	}
 
 	/**
-	 * Begin the destruction of this packet writer. It can happen in two ways:
-	 * in the first case the client disconnected while saving the map. In this
-	 * case the saving has not finished and killed this PacketWriter. In that
-	 * case we simply set cs to NULL, triggering the appending to fail due to
-	 * the connection problem and eventually triggering the destructor. In the
-	 * second case the destructor is already called, and it is waiting for our
-	 * signal which we will send. Only then the packets will be removed by the
-	 * destructor.
+	 * Mark the savegame as complete, or the writer as gone.
+	 * @param finished Whether the savegame is complete.
 	 */
-	void Destroy()
+	void EndSaving(bool finished)
 	{
-		if (this->mutex != NULL) this->mutex->BeginCritical();
-
-		this->cs = NULL;
-
-		if (this->mutex != NULL) this->mutex->SendSignal();
-
-		if (this->mutex != NULL) this->mutex->EndCritical();
-
-		/* Make sure the saving is completely cancelled. Yes,
-		 * we need to handle the save finish as well as the
-		 * next connection might just be requesting a map. */
-		WaitTillSaved();
-		ProcessAsyncSaveFinish();
+		this->mutex->BeginCritical();
+		this->finished = this->finished || finished;
+		this->saving = false;
+		this->mutex->EndCritical();
 	}
 
 	/**
-	 * Checks whether there are packets.
-	 * It's not 100% threading safe, but this is only asked for when checking
-	 * whether there still is something to send. Then another call will be made
-	 * to actually get the Packet, which will be the only one popping packets
-	 * and thus eventually setting this on false.
+	 * Get the size of the savegame, once it is complete.
+	 * @return The size, or 0 when the savegame is still being written.
 	 */
-	bool HasPackets()
+	size_t GetFinishedSize()
 	{
-		return this->packets != NULL;
+		this->mutex->BeginCritical();
+		size_t size = this->finished ? this->size : 0;
+		this->mutex->EndCritical();
+		return size;
 	}
 
 	/**
-	 * Pop a single created packet from the queue with packets.
+	 * Make the next packet of the savegame for a client.
+	 * @param[in,out] sent How much of the savegame the client got already.
+	 * @return The packet; \c PACKET_SERVER_MAP_DONE after the last data. \c NULL
+	 *         when the savegame is still being written and there is no full packet yet.
 	 */
-	Packet *PopPacket()
+	Packet *NextPacket(size_t *sent)
 	{
-		if (this->mutex != NULL) this->mutex->BeginCritical();
-
-		Packet *p = this->packets;
-		this->packets = p->next;
-		p->next = NULL;
-
-		if (this->mutex != NULL) this->mutex->EndCritical();
+		this->mutex->BeginCritical();
+
+		size_t available = this->size - *sent;
+		Packet *p = NULL;
+		if (available >= (size_t)(SEND_MTU - 3) || (this->finished && available > 0)) {
+			p = new Packet(PACKET_SERVER_MAP_DATA);
+			size_t to_write = min(available, (size_t)(SEND_MTU - p->size));
+			while (to_write > 0) {
+				size_t offset = *sent % BLOCK_SIZE;
+				size_t len = min(BLOCK_SIZE - offset, to_write);
+				memcpy(p->buffer + p->size, this->blocks[*sent / BLOCK_SIZE] + offset, len);
+				p->size += (PacketSize)len;
+				*sent += len;
+				to_write -= len;
+			}
+		} else if (this->finished) {
+			p = new Packet(PACKET_SERVER_MAP_DONE);
+		}
 
+		this->mutex->EndCritical();
 		return p;
 	}
 
-	/** Append the current packet to the queue. */
-	void AppendQueue()
+	/** Add a client that receives this savegame. */
+	void AddClient()
 	{
-		if (this->current == NULL) return;
-
-		Packet **p = &this->packets;
-		while (*p != NULL) {
-			p = &(*p)->next;
-		}
-		*p = this->current;
-
-		this->current = NULL;
+		this->mutex->BeginCritical();
+		this->clients++;
+		this->mutex->EndCritical();
 	}
 
-	/* virtual */ void Write(byte *buf, size_t size)
+	/**
+	 * Remove a client that does not need this savegame anymore. When it was
+	 * the last one, the saving is aborted and the snapshot is deleted.
+	 */
+	void RemoveClient()
 	{
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == NULL) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+		this->mutex->BeginCritical();
+		bool last = --this->clients == 0;
+		this->mutex->EndCritical();
+		if (!last) return;
 
-		if (this->current == NULL) this->current = new Packet(PACKET_SERVER_MAP_DATA);
+		/* Make sure the saving is completely cancelled. Yes,
+		 * we need to handle the save finish as well as the
+		 * next connection might just be requesting a map. */
+		WaitTillSaved();
+		ProcessAsyncSaveFinish();
 
-		if (this->mutex != NULL) this->mutex->BeginCritical();
+		assert(!this->saving);
+		delete this;
+	}
+};
 
-		byte *bufe = buf + size;
-		while (buf != bufe) {
-			size_t to_write = min(SEND_MTU - this->current->size, bufe - buf);
-			memcpy(this->current->buffer + this->current->size, buf, to_write);
-			this->current->size += (PacketSize)to_write;
-			buf += to_write;
+/** The snapshot of the most recent frame a client requested the map in, if any client still receives it. */
+static NetworkMapSnapshot *_network_map_snapshot = NULL;
 
-			if (this->current->size == SEND_MTU) {
-				this->AppendQueue();
-				if (buf != bufe) this->current = new Packet(PACKET_SERVER_MAP_DATA);
-			}
-		}
+/** Clean up the snapshot. */
+NetworkMapSnapshot::~NetworkMapSnapshot()
+{
+	if (_network_map_snapshot == this) _network_map_snapshot = NULL;
+	delete this->mutex;
+}
 
-		if (this->mutex != NULL) this->mutex->EndCritical();
+/** Writing a savegame directly into a snapshot for joining clients. */
+struct PacketWriter : SaveFilter {
+	NetworkMapSnapshot *snapshot; ///< The snapshot to write to.
 
-		this->total_size += size;
+	/**
+	 * Create the packet writer.
+	 * @param snapshot The snapshot to write to.
+	 */
+	PacketWriter(NetworkMapSnapshot *snapshot) : SaveFilter(NULL), snapshot(snapshot)
+	{
 	}
 
-	/* virtual */ void Finish()
+	/** Let the snapshot know the writing has ended. */
+	~PacketWriter()
 	{
-		/* We want to abort the saving when the socket is closed. */
-		if (this->cs == NULL) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
-
-		if (this->mutex != NULL) this->mutex->BeginCritical();
-
-		/* Make sure the last packet is flushed. */
-		this->AppendQueue();
-
-		/* Add a packet stating that this is the end to the queue. */
-		this->current = new Packet(PACKET_SERVER_MAP_DONE);
-		this->AppendQueue();
+		this->snapshot->EndSaving(false);
+	}
 
-		/* Fast-track the size to the client. */
-		Packet *p = new Packet(PACKET_SERVER_MAP_SIZE);
-		p->Send_uint32((uint32)this->total_size);
-		this->cs->NetworkTCPSocketHandler::SendPacket(p);
+	/* virtual */ void Write(byte *buf, size_t size)
+	{
+		/* We want to abort the saving when all sockets are closed. */
+		if (!this->snapshot->Append(buf, size)) SlError(STR_NETWORK_ERROR_LOSTCONNECTION);
+	}
 
-		if (this->mutex != NULL) this->mutex->EndCritical();
+	/* virtual */ void Finish()
+	{
+		this->snapshot->EndSaving(true);
 	}
 };
 
@@ -239,7 +254,7 @@ ServerNetworkGameSocketHandler::~ServerNetworkGameSocketHandler()
 	OrderBackup::ResetUser(this->client_id);
 
 	if (this->savegame != NULL) {
-		this->savegame->Destroy();
+		this->savegame->RemoveClient();
 		this->savegame = NULL;
 	}
 }
@@ -573,15 +588,20 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendWait()
 /** This sends the map to the client */
 NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 {
-	static uint sent_packets; // How many packets we did send successfully last time
-
 	if (this->status < STATUS_AUTHORIZED) {
 		/* Illegal call, return error and ignore the packet */
 		return this->SendError(NETWORK_ERROR_NOT_AUTHORIZED);
 	}
 
 	if (this->status == STATUS_AUTHORIZED) {
-		this->savegame = new PacketWriter(this);
+		/* Clients that start downloading in the same frame share the savegame. */
+		bool new_snapshot = _network_map_snapshot == NULL || _network_map_snapshot->frame != _frame_counter;
+		if (new_snapshot) _network_map_snapshot = new NetworkMapSnapshot();
+
+		this->savegame = _network_map_snapshot;
+		this->savegame->AddClient();
+		this->savegame_sent = 0;
+		this->savegame_size_sent = false;
 
 		/* Now send the _frame_counter and how many packets are coming */
 		Packet *p = new Packet(PACKET_SERVER_MAP_BEGIN);
@@ -594,32 +614,52 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		this->last_frame = _frame_counter;
 		this->last_frame_server = _frame_counter;
 
-		sent_packets = 4; // We start with trying 4 packets
-
-		/* The order backups are broken in 1.4, so that joining clients cannot
-		 * restore orders backupped before they joined.
-		 *
-		 * When loading the game on the new client, we have to drop all order backups.
-		 * As such this client will desync, in case an order backup is actually restored.
-		 *
-		 * To lower the desync chance, the server resets all order backups when a client
-		 * joins, so a desync is only possible when the restore command is queued at the server
-		 * while the saving is executed. */
-		NetworkClientSocket *cs;
-		FOR_ALL_CLIENT_SOCKETS(cs) {
-			OrderBackup::ResetUser(cs->client_id);
-		}
+		this->savegame_packets = 4; // We start with trying 4 packets
+
+		if (new_snapshot) {
+			/* The order backups are broken in 1.4, so that joining clients cannot
+			 * restore orders backupped before they joined.
+			 *
+			 * When loading the game on the new client, we have to drop all order backups.
+			 * As such this client will desync, in case an order backup is actually restored.
+			 *
+			 * To lower the desync chance, the server resets all order backups when a client
+			 * joins, so a desync is only possible when the restore command is queued at the server
+			 * while the saving is executed. */
+			NetworkClientSocket *cs;
+			FOR_ALL_CLIENT_SOCKETS(cs) {
+				OrderBackup::ResetUser(cs->client_id);
+			}
 
-		/* Make a dump of the current game */
-		if (SaveWithFilter(this->savegame, true) != SL_OK) usererror("network savedump failed");
+			/* The savegame of an earlier frame might still be finishing. */
+			WaitTillSaved();
+			ProcessAsyncSaveFinish();
+
+			/* Make a dump of the current game */
+			if (SaveWithFilter(new PacketWriter(this->savegame), true) != SL_OK) usererror("network savedump failed");
+		}
 	}
 
 	if (this->status == STATUS_MAP) {
 		bool last_packet = false;
 		bool has_packets = false;
 
-		for (uint i = 0; (has_packets = this->savegame->HasPackets()) && i < sent_packets; i++) {
-			Packet *p = this->savegame->PopPacket();
+		if (!this->savegame_size_sent) {
+			size_t size = this->savegame->GetFinishedSize();
+			if (size != 0) {
+				/* Fast-track the size to the client. */
+				Packet *p = new Packet(PACKET_SERVER_MAP_SIZE);
+				p->Send_uint32((uint32)size);
+				this->NetworkTCPSocketHandler::SendPacket(p);
+				this->savegame_size_sent = true;
+			}
+		}
+
+		for (uint i = 0; i < this->savegame_packets; i++) {
+			Packet *p = this->savegame->NextPacket(&this->savegame_sent);
+			if (p == NULL) break;
+
+			has_packets = true;
 			last_packet = p->buffer[2] == PACKET_SERVER_MAP_DONE;
 
 			this->SendPacket(p);
@@ -631,34 +671,21 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 		}
 
 		if (last_packet) {
-			/* Done reading, make sure saving is done as well */
-			this->savegame->Destroy();
+			/* Done reading, make sure saving is done as well when we were the last one */
+			this->savegame->RemoveClient();
 			this->savegame = NULL;
 
 			/* Set the status to DONE_MAP, no we will wait for the client
 			 *  to send it is ready (maybe that happens like never ;)) */
 			this->status = STATUS_DONE_MAP;
 
-			/* Find the best candidate for joining, i.e. the first joiner. */
+			/* Let everyone that is waiting start joining; as they start in
+			 * the same frame they all share one new savegame. */
 			NetworkClientSocket *new_cs;
-			NetworkClientSocket *best = NULL;
 			FOR_ALL_CLIENT_SOCKETS(new_cs) {
 				if (new_cs->status == STATUS_MAP_WAIT) {
-					if (best == NULL || best->GetInfo()->join_date > new_cs->GetInfo()->join_date || (best->GetInfo()->join_date == new_cs->GetInfo()->join_date && best->client_id > new_cs->client_id)) {
-						best = new_cs;
-					}
-				}
-			}
-
-			/* Is there someone else to join? */
-			if (best != NULL) {
-				/* Let the first start joining. */
-				best->status = STATUS_AUTHORIZED;
-				best->SendMap();
-
-				/* And update the rest. */
-				FOR_ALL_CLIENT_SOCKETS(new_cs) {
-					if (new_cs->status == STATUS_MAP_WAIT) new_cs->SendWait();
+					new_cs->status = STATUS_AUTHORIZED;
+					new_cs->SendMap();
 				}
 			}
 		}
@@ -669,7 +696,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 
 			case SPS_ALL_SENT:
 				/* All are sent, increase the sent_packets */
-				if (has_packets) sent_packets *= 2;
+				if (has_packets) this->savegame_packets *= 2;
 				break;
 
 			case SPS_PARTLY_SENT:
@@ -678,7 +705,7 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendMap()
 
 			case SPS_NONE_SENT:
 				/* Not everything is sent, decrease the sent_packets */
-				if (sent_packets > 1) sent_packets /= 2;
+				if (this->savegame_packets > 1) this->savegame_packets /= 2;
 				break;
 		}
 	}
@@ -752,6 +779,37 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommand(const CommandPacke
 	return NETWORK_RECV_STATUS_OKAY;
 }
 
+/**
+ * Send all queued commands to the client, as many as fit in each packet.
+ * Only for clients that understand #PACKET_SERVER_COMMANDS.
+ */
+NetworkRecvStatus ServerNetworkGameSocketHandler::SendCommands()
+{
+	Packet *p = NULL;
+	CommandPacket prev;
+
+	CommandPacket *cp;
+	while ((cp = this->outgoing_queue.Pop()) != NULL) {
+		if (p != NULL && p->size + COMPACT_COMMAND_MAX_SIZE + strlen(cp->text) > SEND_MTU) {
+			this->SendPacket(p);
+			p = NULL;
+		}
+
+		if (p == NULL) {
+			p = new Packet(PACKET_SERVER_COMMANDS);
+			this->NetworkGameSocketHandler::SendCompactCommand(p, cp, NULL);
+		} else {
+			this->NetworkGameSocketHandler::SendCompactCommand(p, cp, &prev);
+		}
+
+		prev = *cp;
+		free(cp);
+	}
+
+	if (p != NULL) this->SendPacket(p);
+	return NETWORK_RECV_STATUS_OKAY;
+}
+
 /**
  * Send a chat message.
  * @param action The action associated with the message.
@@ -928,6 +986,9 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_JOIN(Packet *p)
 	p->Recv_string(name, sizeof(name));
 	playas = (Owner)p->Recv_uint8();
 	client_lang = (NetworkLanguage)p->Recv_uint8();
+	/* Older clients do not tell which features they support. */
+	NetworkClientFeatures features = p->pos < p->size ? (NetworkClientFeatures)p->Recv_uint8() : NCF_NONE;
+	this->compact_commands = (features & NCF_COMPACT_COMMANDS) != 0;
 
 	if (this->HasClientQuit()) return NETWORK_RECV_STATUS_CONN_LOST;
 
@@ -1036,9 +1097,11 @@ NetworkRecvStatus ServerNetworkGameSocketHandler::Receive_CLIENT_GETMAP(Packet *
 		return this->SendError(NETWORK_ERROR_NOT_AUTHORIZED);
 	}
 
-	/* Check if someone else is receiving the map */
+	/* Check if someone else is receiving the map of an earlier frame; a
+	 * savegame made in this frame can be shared with the new client. */
+	bool shared = _network_map_snapshot != NULL && _network_map_snapshot->frame == _frame_counter;
 	FOR_ALL_CLIENT_SOCKETS(new_cs) {
-		if (new_cs->status == STATUS_MAP) {
+		if (new_cs->status == STATUS_MAP && !shared) {
 			/* Tell the new client to wait */
 			this->status = STATUS_MAP_WAIT;
 			return this->SendWait();
@@ -1802,6 +1865,11 @@ void NetworkServerSetCompanyPassword(CompanyID company_id, const char *password,
  */
 static void NetworkHandleCommandQueue(NetworkClientSocket *cs)
 {
+	if (cs->compact_commands) {
+		cs->SendCommands();
+		return;
+	}
+
 	CommandPacket *cp;
 	while ((cp = cs->outgoing_queue.Pop()) != NULL) {
 		cs->SendCommand(cp);
@@ -1934,6 +2002,9 @@ void NetworkServer_Tick(bool send_frame)
 		}
 	}
 
+	/* Tell the admins about changed companies */
+	NetworkAdminCompanyChanges();
+
 	/* See if we need to advertise */
 	NetworkUDPAdvertise();
 }
@@ -74,8 +74,12 @@ public:
 	ClientStatus status;         ///< Status of this client
 	CommandQueue outgoing_queue; ///< The command-queue awaiting delivery
 	int receive_limit;           ///< Amount of bytes that we can receive at this moment
+	bool compact_commands;       ///< Whether the client understands #PACKET_SERVER_COMMANDS.
 
-	struct PacketWriter *savegame; ///< Writer used to write the savegame.
+	struct NetworkMapSnapshot *savegame; ///< Snapshot of the savegame the client is downloading.
+	size_t savegame_sent;          ///< Amount of the savegame that has been put in packets for the client.
+	uint savegame_packets;         ///< Number of savegame packets we try to send to the client at once.
+	bool savegame_size_sent;       ///< Whether the client has been told the size of the savegame.
 	NetworkAddress client_address; ///< IP-address of the client (so he can be banned)
 
 	ServerNetworkGameSocketHandler(SOCKET s);
@@ -100,6 +104,7 @@ public:
 	NetworkRecvStatus SendFrame();
 	NetworkRecvStatus SendSync();
 	NetworkRecvStatus SendCommand(const CommandPacket *cp);
+	NetworkRecvStatus SendCommands();
 	NetworkRecvStatus SendCompanyUpdate();
 	NetworkRecvStatus SendConfigUpdate();
 
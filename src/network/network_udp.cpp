@@ -685,6 +685,17 @@ void NetworkUDPClose()
 	DEBUG(net, 1, "[udp] closed listeners");
 }
 
+/**
+ * Close the descriptors of the UDP sockets in a forked process, without
+ * taking the lock; the thread holding it might not exist in this process.
+ */
+void NetworkUDPCloseInheritedSockets()
+{
+	if (_udp_server_socket != NULL) _udp_server_socket->Close();
+	if (_udp_master_socket != NULL) _udp_master_socket->Close();
+	if (_udp_client_socket != NULL) _udp_client_socket->Close();
+}
+
 /** Receive the UDP packets. */
 void NetworkBackgroundUDPLoop()
 {
@@ -65,6 +65,7 @@
 #include "viewport_sprite_sorter.h"
 
 #include "linkgraph/linkgraphschedule.h"
+#include "tick_profiler.h"
 
 #include <stdarg.h>
 
@@ -79,6 +80,7 @@ bool HandleBootstrap();
 extern Company *DoStartupNewCompany(bool is_ai, CompanyID company = INVALID_COMPANY);
 extern void ShowOSErrorBox(const char *buf, bool system);
 extern char *_config_file;
+extern void StateGameLoop();
 
 /**
  * Error handling for fatal user errors.
@@ -175,6 +177,10 @@ static void ShowHelp()
 		"  -c config_file      = Use 'config_file' instead of 'openttd.cfg'\n"
 		"  -x                  = Do not automatically save to config file on exit\n"
 		"  -q savegame         = Write some information about the savegame and exit\n"
+		"  -B ticks            = Run the savegame given by -g for a number of ticks as\n"
+		"                        fast as possible, report the timings and exit\n"
+		"  -R rounds           = Save and load the savegame given by -g in memory with\n"
+		"                        every savegame format, report the timings and exit\n"
 		"\n",
 		lastof(buf)
 	);
@@ -255,6 +261,111 @@ static void WriteSavegameInfo(const char *name)
 }
 
 
+/**
+ * Calculate a checksum over the state of the game, so different runs of
+ * the same benchmark can be verified to have simulated the same thing.
+ * @return The checksum.
+ */
+static uint32 CalculateStateChecksum()
+{
+	uint32 checksum = 2166136261U;
+
+	/* FNV-1a over all map arrays. */
+	const byte *data = (const byte *)_m;
+	for (size_t i = 0; i < MapSize() * sizeof(*_m); i++) checksum = (checksum ^ data[i]) * 16777619U;
+	data = (const byte *)_me;
+	for (size_t i = 0; i < MapSize() * sizeof(*_me); i++) checksum = (checksum ^ data[i]) * 16777619U;
+
+	/* And the most important properties of the vehicles. */
+	const Vehicle *v;
+	FOR_ALL_VEHICLES(v) {
+		uint32 values[] = { v->index, (uint32)v->x_pos, (uint32)v->y_pos, (uint32)v->z_pos, v->cur_speed, v->cargo.StoredCount(), (uint32)v->profit_this_year };
+		for (uint i = 0; i < lengthof(values); i++) checksum = (checksum ^ values[i]) * 16777619U;
+	}
+
+	return checksum;
+}
+
+/**
+ * Load the savegame given by -g for one of the benchmarks.
+ * @return Whether the savegame could be loaded.
+ */
+static bool LoadBenchmarkSavegame()
+{
+	if (_switch_mode != SM_LOAD_GAME) {
+		fprintf(stderr, "A savegame to benchmark has to be given with -g\n");
+		return false;
+	}
+
+	SwitchToMode(_switch_mode);
+	_switch_mode = SM_NONE;
+
+	if (_game_mode != GM_NORMAL) {
+		fprintf(stderr, "Failed to load savegame '%s'\n", _file_to_saveload.name);
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * Run the loaded game for a fixed number of ticks, without any pacing
+ * or drawing, and report the time it took per phase of the game loop.
+ * @param ticks The number of ticks to run.
+ * @return 0 when the benchmark could be run.
+ */
+static int RunBenchmark(uint ticks)
+{
+	if (!LoadBenchmarkSavegame()) return 1;
+
+	/* A benchmark should not be influenced by the state the game was saved in. */
+	_pause_mode = PM_UNPAUSED;
+	ResetTickProfiler();
+
+	uint64 start = GetTickProfilerTime();
+	for (uint i = 0; i < ticks; i++) StateGameLoop();
+	uint64 duration = max<uint64>(GetTickProfilerTime() - start, 1);
+
+	printf("Savegame:   %s\n", _file_to_saveload.name);
+	printf("Ticks:      %u\n", ticks);
+	printf("Time:       %.3f s\n", duration / 1000000.0);
+	printf("Ticks/s:    %.1f\n", ticks * 1000000.0 / duration);
+	printf("\n%-15s %12s %10s %7s\n", "phase", "total [ms]", "avg [us]", "share");
+	for (uint i = 0; i < TP_END; i++) {
+		const TickPhaseHistory &h = _tick_profile[i];
+		printf("%-15s %12.1f %10u %6.1f%%\n", GetTickPhaseName((TickPhase)i), h.total_time / 1000.0, h.GetAverage(), h.total_time * 100.0 / duration);
+	}
+	printf("\nChecksum:   %08X %08X:%08X\n", CalculateStateChecksum(), _random.state[0], _random.state[1]);
+
+	return 0;
+}
+
+/**
+ * Save and load the loaded game with every savegame format and report
+ * the time it took, the size of the savegames and the time per chunk.
+ * @param rounds How often to save and load the game per format.
+ * @return 0 when the benchmark could be run.
+ */
+static int RunSaveLoadBenchmark(uint rounds)
+{
+	if (!LoadBenchmarkSavegame()) return 1;
+
+	uint32 checksum = CalculateStateChecksum();
+
+	printf("Savegame:   %s\n", _file_to_saveload.name);
+	printf("Rounds:     %u\n\n", rounds);
+	if (!BenchmarkSaveLoad(rounds)) return 1;
+
+	/* Saving and loading must not have changed anything. */
+	if (CalculateStateChecksum() != checksum) {
+		fprintf(stderr, "\nThe game changed by saving and loading it\n");
+		return 1;
+	}
+	printf("\nChecksum:   %08X\n", checksum);
+
+	return 0;
+}
+
 /**
  * Extract the resolution from the given string and store
  * it in the 'res' parameter.
@@ -501,6 +612,8 @@ static const OptionData _options[] = {
 	 GETOPT_SHORT_VALUE('s'),
 	 GETOPT_SHORT_VALUE('v'),
 	 GETOPT_SHORT_VALUE('b'),
+	 GETOPT_SHORT_VALUE('B'),
+	 GETOPT_SHORT_VALUE('R'),
 #if defined(ENABLE_NETWORK)
 	GETOPT_SHORT_OPTVAL('D'),
 	GETOPT_SHORT_OPTVAL('n'),
@@ -540,6 +653,8 @@ int openttd_main(int argc, char *argv[])
 	char *sounds_set = NULL;
 	char *music_set = NULL;
 	Dimension resolution = {0, 0};
+	uint benchmark_ticks = 0;
+	uint benchmark_rounds = 0;
 	/* AfterNewGRFScan sets save_config to true after scanning completed. */
 	bool save_config = false;
 	AfterNewGRFScan *scanner = new AfterNewGRFScan(&save_config);
@@ -568,6 +683,23 @@ int openttd_main(int argc, char *argv[])
 		case 's': free(sounddriver); sounddriver = strdup(mgo.opt); break;
 		case 'v': free(videodriver); videodriver = strdup(mgo.opt); break;
 		case 'b': free(blitter); blitter = strdup(mgo.opt); break;
+		case 'B':
+		case 'R':
+			free(musicdriver);
+			free(sounddriver);
+			free(videodriver);
+			free(blitter);
+			musicdriver = strdup("null");
+			sounddriver = strdup("null");
+			videodriver = strdup("null");
+			blitter = strdup("null");
+			if (i == 'B') {
+				benchmark_ticks = max(atoi(mgo.opt), 1);
+			} else {
+				benchmark_rounds = max(atoi(mgo.opt), 1);
+			}
+			scanner->save_config = false;
+			break;
 #if defined(ENABLE_NETWORK)
 		case 'D':
 			free(musicdriver);
@@ -851,7 +983,13 @@ int openttd_main(int argc, char *argv[])
 	ScanNewGRFFiles(scanner);
 	scanner = NULL;
 
-	VideoDriver::GetInstance()->MainLoop();
+	if (benchmark_ticks != 0) {
+		ret = RunBenchmark(benchmark_ticks);
+	} else if (benchmark_rounds != 0) {
+		ret = RunSaveLoadBenchmark(benchmark_rounds);
+	} else {
+		VideoDriver::GetInstance()->MainLoop();
+	}
 
 	WaitTillSaved();
 
@@ -1312,12 +1450,28 @@ static void CheckCaches()
 	}
 
 	Station *st;
+	SmallVector<uint, 4> old_amounts;
 	FOR_ALL_STATIONS(st) {
 		for (CargoID c = 0; c < NUM_CARGO; c++) {
+			const StationCargoPacketMap *packets = st->goods[c].cargo.Packets();
+
+			/* The amounts per next hop are not part of the list itself, so check them separately. */
+			old_amounts.Clear();
+			for (StationCargoPacketMap::ConstMapIterator it(packets->begin()); it != packets->end(); ++it) {
+				*old_amounts.Append() = it->second.amount;
+			}
+
 			byte buff[sizeof(StationCargoList)];
 			memcpy(buff, &st->goods[c].cargo, sizeof(StationCargoList));
 			st->goods[c].cargo.InvalidateCache();
 			assert(memcmp(&st->goods[c].cargo, buff, sizeof(StationCargoList)) == 0);
+
+			uint i = 0;
+			for (StationCargoPacketMap::ConstMapIterator it(packets->begin()); it != packets->end(); ++it, ++i) {
+				if (old_amounts[i] != it->second.amount) {
+					DEBUG(desync, 2, "station cargo amount mismatch: station %i, cargo %i, next hop %i", (int)st->index, (int)c, (int)it->first);
+				}
+			}
 		}
 	}
 }
@@ -1342,15 +1496,23 @@ void StateGameLoop()
 
 	Layouter::ReduceLineCache();
 
+	TickPhaseTimer tick_timer;
+
 	if (_game_mode == GM_EDITOR) {
 		BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
+		tick_timer.Skip();
 		RunTileLoop();
+		tick_timer.Next(TP_TILE_LOOP);
 		CallVehicleTicks();
+		tick_timer.Next(TP_VEHICLE_TICKS);
 		CallLandscapeTick();
+		tick_timer.Next(TP_LANDSCAPE_TICK);
 		BasePersistentStorageArray::SwitchMode(PSM_LEAVE_GAMELOOP);
 		UpdateLandscapingLimits();
 
+		tick_timer.Skip();
 		CallWindowTickEvent();
+		tick_timer.Next(TP_WINDOW_TICK);
 		NewsLoop();
 	} else {
 		if (_debug_desync_level > 2 && _date_fract == 0 && (_date & 0x1F) == 0) {
@@ -1367,20 +1529,31 @@ void StateGameLoop()
 		Backup<CompanyByte> cur_company(_current_company, OWNER_NONE, FILE_LINE);
 
 		BasePersistentStorageArray::SwitchMode(PSM_ENTER_GAMELOOP);
+		tick_timer.Skip();
 		AnimateAnimatedTiles();
+		tick_timer.Next(TP_ANIMATE_TILES);
 		IncreaseDate();
+		tick_timer.Next(TP_INCREASE_DATE);
 		RunTileLoop();
+		tick_timer.Next(TP_TILE_LOOP);
 		CallVehicleTicks();
+		tick_timer.Next(TP_VEHICLE_TICKS);
 		CallLandscapeTick();
+		tick_timer.Next(TP_LANDSCAPE_TICK);
 		BasePersistentStorageArray::SwitchMode(PSM_LEAVE_GAMELOOP);
 
 #ifndef DEBUG_DUMP_COMMANDS
+		tick_timer.Skip();
 		AI::GameLoop();
+		tick_timer.Next(TP_AI);
 		Game::GameLoop();
+		tick_timer.Next(TP_GAME_SCRIPT);
 #endif
 		UpdateLandscapingLimits();
 
+		tick_timer.Skip();
 		CallWindowTickEvent();
+		tick_timer.Next(TP_WINDOW_TICK);
 		NewsLoop();
 		cur_company.Restore();
 	}
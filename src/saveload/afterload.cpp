@@ -42,6 +42,7 @@
 #include "../ai/ai_gui.hpp"
 #include "../town.h"
 #include "../economy_base.h"
+#include "../economy_func.h"
 #include "../animated_tile_func.h"
 #include "../subsidy_base.h"
 #include "../subsidy_func.h"
@@ -2939,6 +2940,9 @@ bool AfterLoadGame()
 		FOR_ALL_STATIONS(st) UpdateStationAcceptance(st, false);
 	}
 
+	/* The stations with loading vehicles are a cache as well. */
+	RebuildLoadingStations();
+
 	/* Road stops is 'only' updating some caches */
 	AfterLoadRoadStops();
 	AfterLoadLabelMaps();
@@ -114,11 +114,14 @@ const SaveLoad *GetCargoPacketDesc()
  */
 static void Save_CAPA()
 {
-	CargoPacket *cp;
+	/* Vehicles age their cargo lazily; store the up to date days in transit. */
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) v->cargo.ApplyAging();
 
+	CargoPacket *cp;
 	FOR_ALL_CARGOPACKETS(cp) {
 		SlSetArrayIndex(cp->index);
-		SlObject(cp, GetCargoPacketDesc());
+		SlCompiledObject(cp, GetCargoPacketDesc());
 	}
 }
 
@@ -131,7 +134,7 @@ static void Load_CAPA()
 
 	while ((index = SlIterateArray()) != -1) {
 		CargoPacket *cp = new (index) CargoPacket();
-		SlObject(cp, GetCargoPacketDesc());
+		SlCompiledObject(cp, GetCargoPacketDesc());
 	}
 }
 
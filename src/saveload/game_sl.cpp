@@ -180,5 +180,5 @@ static void Save_GSTR()
 
 extern const ChunkHandler _game_chunk_handlers[] = {
 	{ 'GSTR', Save_GSTR, Load_GSTR, NULL, NULL, CH_ARRAY },
-	{ 'GSDT', Save_GSDT, Load_GSDT, NULL, NULL, CH_ARRAY | CH_LAST},
+	{ 'GSDT', Save_GSDT, Load_GSDT, NULL, NULL, CH_ARRAY | CH_RUNS_SCRIPTS | CH_LAST},
 };
@@ -218,7 +218,7 @@ static void Save_ORDL()
 
 	FOR_ALL_ORDER_LISTS(list) {
 		SlSetArrayIndex(list->index);
-		SlObject(list, GetOrderListDescription());
+		SlCompiledObject(list, GetOrderListDescription());
 	}
 }
 
@@ -229,7 +229,7 @@ static void Load_ORDL()
 	while ((index = SlIterateArray()) != -1) {
 		/* set num_orders to 0 so it's a valid OrderList */
 		OrderList *list = new (index) OrderList(0);
-		SlObject(list, GetOrderListDescription());
+		SlCompiledObject(list, GetOrderListDescription());
 	}
 
 }
@@ -239,7 +239,7 @@ static void Ptrs_ORDL()
 	OrderList *list;
 
 	FOR_ALL_ORDER_LISTS(list) {
-		SlObject(list, GetOrderListDescription());
+		SlCompiledObject(list, GetOrderListDescription());
 	}
 }
 
@@ -30,6 +30,7 @@
 #include "../window_func.h"
 #include "../strings_func.h"
 #include "../core/endian_func.hpp"
+#include "../core/smalldeque_type.hpp"
 #include "../vehicle_base.h"
 #include "../company_func.h"
 #include "../date_func.h"
@@ -48,6 +49,7 @@
 #include "../terraform_gui.h"
 #include "../vehicle_gui.h"
 #include "../company_gui.h"
+#include "../tick_profiler.h"
 #include "table/strings.h"
 
 #include "saveload_internal.h"
@@ -303,20 +305,36 @@ struct ReadBuffer {
 	{
 	}
 
-	inline byte ReadByte()
+	/** Refill the buffer from the filter, as everything in it has been read. */
+	inline void Fill()
 	{
-		if (this->bufp == this->bufe) {
-			size_t len = this->reader->Read(this->buf, lengthof(this->buf));
-			if (len == 0) SlErrorCorrupt("Unexpected end of chunk");
+		size_t len = this->reader->Read(this->buf, lengthof(this->buf));
+		if (len == 0) SlErrorCorrupt("Unexpected end of chunk");
 
-			this->read += len;
-			this->bufp = this->buf;
-			this->bufe = this->buf + len;
-		}
+		this->read += len;
+		this->bufp = this->buf;
+		this->bufe = this->buf + len;
+	}
+
+	inline byte ReadByte()
+	{
+		if (this->bufp == this->bufe) this->Fill();
 
 		return *this->bufp++;
 	}
 
+	/**
+	 * Get the amount of bytes that can be read directly from #bufp,
+	 * refilling the buffer when needed.
+	 * @return The amount of bytes; never 0.
+	 */
+	inline size_t GetAvailable()
+	{
+		if (this->bufp == this->bufe) this->Fill();
+
+		return this->bufe - this->bufp;
+	}
+
 	/**
 	 * Get the size of the memory dump made so far.
 	 * @return The size.
@@ -328,11 +346,18 @@ struct ReadBuffer {
 };
 
 
+/** Where a chunk starts in the uncompressed savegame; used for the chunk index of the block formats. */
+struct ChunkIndexEntry {
+	uint32 id;     ///< The chunk, or 0 for the terminator after the last chunk.
+	uint64 offset; ///< Offset of the chunk's id in the uncompressed savegame.
+};
+
 /** Container for dumping the savegame (quickly) to memory. */
 struct MemoryDumper {
 	AutoFreeSmallVector<byte *, 16> blocks; ///< Buffer with blocks of allocated memory.
 	byte *buf;                              ///< Buffer we're going to write to.
 	byte *bufe;                             ///< End of the buffer we write to.
+	SmallVector<ChunkIndexEntry, 64> chunks; ///< Where the chunks start in the dump.
 
 	/** Initialise our variables. */
 	MemoryDumper() : buf(NULL), bufe(NULL)
@@ -346,15 +371,31 @@ struct MemoryDumper {
 	inline void WriteByte(byte b)
 	{
 		/* Are we at the end of this chunk? */
-		if (this->buf == this->bufe) {
-			this->buf = CallocT<byte>(MEMORY_CHUNK_SIZE);
-			*this->blocks.Append() = this->buf;
-			this->bufe = this->buf + MEMORY_CHUNK_SIZE;
-		}
+		if (this->buf == this->bufe) this->AllocateBlock();
 
 		*this->buf++ = b;
 	}
 
+	/** Start a new block, as the current one is full. */
+	inline void AllocateBlock()
+	{
+		this->buf = CallocT<byte>(MEMORY_CHUNK_SIZE);
+		*this->blocks.Append() = this->buf;
+		this->bufe = this->buf + MEMORY_CHUNK_SIZE;
+	}
+
+	/**
+	 * Get the amount of bytes that can be written directly to #buf,
+	 * starting a new block when needed.
+	 * @return The amount of bytes; never 0.
+	 */
+	inline size_t GetSpace()
+	{
+		if (this->buf == this->bufe) this->AllocateBlock();
+
+		return this->bufe - this->buf;
+	}
+
 	/**
 	 * Flush this dumper into a writer.
 	 * @param writer The filter we want to use.
@@ -382,6 +423,48 @@ struct MemoryDumper {
 	{
 		return this->blocks.Length() * MEMORY_CHUNK_SIZE - (this->bufe - this->buf);
 	}
+
+	/**
+	 * Write a buffer into the dumper.
+	 * @param buf The buffer to write.
+	 * @param len The amount of data to write.
+	 */
+	void Write(const byte *buf, size_t len)
+	{
+		while (len > 0) {
+			size_t to_copy = min(len, this->GetSpace());
+			memcpy(this->buf, buf, to_copy);
+			this->buf += to_copy;
+			buf += to_copy;
+			len -= to_copy;
+		}
+	}
+
+	/**
+	 * Copy a part of the memory dump.
+	 * @param offset Where in the dump to start.
+	 * @param buf    Buffer to copy to.
+	 * @param len    The amount of data to copy.
+	 */
+	void CopyTo(size_t offset, byte *buf, size_t len) const
+	{
+		assert(offset + len <= this->GetSize());
+		while (len > 0) {
+			size_t in_block = offset % MEMORY_CHUNK_SIZE;
+			size_t to_copy = min(MEMORY_CHUNK_SIZE - in_block, len);
+			memcpy(buf, this->blocks[offset / MEMORY_CHUNK_SIZE] + in_block, to_copy);
+			buf += to_copy;
+			offset += to_copy;
+			len -= to_copy;
+		}
+	}
+};
+
+/** What to save of the savegame in the delta savegame mode. */
+enum SaveDeltaMode {
+	SDM_NONE,  ///< A normal savegame.
+	SDM_BASE,  ///< A delta savegame against a new base, which is written first.
+	SDM_DELTA, ///< A delta savegame against a base.
 };
 
 /** The saveload struct, containing reader-writer functions, buffer, version, etc. */
@@ -395,6 +478,7 @@ struct SaveLoadParams {
 	int array_index, last_array_index;   ///< in the case of an array, the current and last positions
 
 	MemoryDumper *dumper;                ///< Memory dumper to write the savegame to.
+	MemoryDumper *presaved;              ///< The chunks that run scripts, saved before the others, or \c NULL.
 	SaveFilter *sf;                      ///< Filter to write the savegame to.
 
 	ReadBuffer *reader;                  ///< Savegame reading buffer.
@@ -402,6 +486,13 @@ struct SaveLoadParams {
 
 	StringID error_str;                  ///< the translatable error message to show
 	char *extra_msg;                     ///< the error message
+	ThreadObject *loader_thread;         ///< The thread reading the savegame ahead while loading, or \c NULL.
+	bool no_threads;                     ///< Whether no threads may be started, like in a forked process.
+
+	SaveDeltaMode delta_mode;            ///< What to save of the savegame, for delta autosaves.
+	const struct SaveLoadFormat *format; ///< Format to save with instead of #_savegame_format, or \c NULL.
+	byte compression;                    ///< Compression level to save with when #format is set.
+	char delta_base[MAX_PATH];           ///< The base of the delta autosaves.
 
 	byte ff_state;                       ///< The state of fast-forward when saving started.
 	bool saveinprogress;                 ///< Whether there is currently a save in progress.
@@ -514,6 +605,12 @@ static void SlNullPointers()
 	assert(_sl.action == SLA_NULL);
 }
 
+/** An error raised by SlError on the savegame loader thread. */
+struct SlLoaderError {
+	StringID string; ///< The translatable error message to show.
+	char *extra_msg; ///< An extra error message, or \c NULL; to be freed by the catcher.
+};
+
 /**
  * Error handler. Sets everything up to show an error message and to clean
  * up the mess of a partial savegame load.
@@ -524,6 +621,16 @@ static void SlNullPointers()
  */
 void NORETURN SlError(StringID string, const char *extra_msg)
 {
+	/* The loader thread must not touch the state of the main thread; it
+	 * hands the error over, so the main thread can raise it once it runs
+	 * out of the data read before the error. */
+	if (_sl.loader_thread != NULL && _sl.loader_thread->IsCurrent()) {
+		SlLoaderError error;
+		error.string = string;
+		error.extra_msg = (extra_msg == NULL) ? NULL : strdup(extra_msg);
+		throw error;
+	}
+
 	/* Distinguish between loading into _load_check_data vs. normal save/load. */
 	if (_sl.action == SLA_LOAD_CHECK) {
 		_load_check_data.error = string;
@@ -556,6 +663,22 @@ void NORETURN SlErrorCorrupt(const char *msg)
 }
 
 
+#if defined(UNIX) && !defined(__MORPHOS__) && !defined(__APPLE__)
+/* Autosaves can be written by a forked process. Not on OS X, where the
+ * system frameworks may not be used anymore after fork(). */
+#	define WITH_SAVE_SNAPSHOT
+#	include <errno.h>
+#	include <unistd.h>
+#	include <sys/stat.h>
+#	include <sys/wait.h>
+
+static pid_t _save_snapshot_pid = -1; ///< The process writing an autosave snapshot, or -1 when there is none.
+static int _save_snapshot_fd = -1;    ///< Pipe on which that process reports why it failed.
+static struct stat _save_snapshot_file; ///< The savegame that process writes.
+static bool StartSaveSnapshot(FILE *file);
+static void CheckSaveSnapshot(bool block);
+#endif /* UNIX && !__MORPHOS__ && !__APPLE__ */
+
 typedef void (*AsyncSaveFinishProc)();                ///< Callback for when the savegame loading is finished.
 static AsyncSaveFinishProc _async_save_finish = NULL; ///< Callback to call when the savegame loading is finished.
 static ThreadObject *_save_thread;                    ///< The thread we're using to compress and write a savegame
@@ -577,6 +700,10 @@ static void SetAsyncSaveFinish(AsyncSaveFinishProc proc)
  */
 void ProcessAsyncSaveFinish()
 {
+#if defined(WITH_SAVE_SNAPSHOT)
+	CheckSaveSnapshot(false);
+#endif
+
 	if (_async_save_finish == NULL) return;
 
 	_async_save_finish();
@@ -913,10 +1040,22 @@ static void SlCopyBytes(void *ptr, size_t length)
 	switch (_sl.action) {
 		case SLA_LOAD_CHECK:
 		case SLA_LOAD:
-			for (; length != 0; length--) *p++ = SlReadByte();
+			while (length != 0) {
+				size_t len = min(length, _sl.reader->GetAvailable());
+				memcpy(p, _sl.reader->bufp, len);
+				_sl.reader->bufp += len;
+				p += len;
+				length -= len;
+			}
 			break;
 		case SLA_SAVE:
-			for (; length != 0; length--) SlWriteByte(*p++);
+			while (length != 0) {
+				size_t len = min(length, _sl.dumper->GetSpace());
+				memcpy(_sl.dumper->buf, p, len);
+				_sl.dumper->buf += len;
+				p += len;
+				length -= len;
+			}
 			break;
 		default: NOT_REACHED();
 	}
@@ -1219,6 +1358,169 @@ void SlArray(void *array, size_t length, VarType conv)
 	}
 }
 
+/**
+ * Copy bytes from every \a Tstride'th byte of \a src to \a dst.
+ * With the stride known at compile time the compiler can turn this
+ * into shuffles of whole vectors.
+ * @param dst   The bytes to write to.
+ * @param src   The first byte to copy.
+ * @param count The number of bytes to copy.
+ */
+template <size_t Tstride>
+static inline void GatherBytes(byte *dst, const byte *src, size_t count)
+{
+	for (size_t i = 0; i < count; i++) dst[i] = src[i * Tstride];
+}
+
+/**
+ * Copy bytes from \a src to every \a Tstride'th byte of \a dst.
+ * @param dst   The first byte to write to.
+ * @param src   The bytes to copy.
+ * @param count The number of bytes to copy.
+ */
+template <size_t Tstride>
+static inline void ScatterBytes(byte *dst, const byte *src, size_t count)
+{
+	for (size_t i = 0; i < count; i++) dst[i * Tstride] = src[i];
+}
+
+/**
+ * Save or load a byte from each element of an array of structures, e.g. one
+ * of the fields of the map array, directly from or to the buffers of the
+ * savegame. In the savegame the bytes are stored consecutively, like SlArray
+ * with SLE_UINT8 does.
+ * @param ptr    The byte in the first element of the array.
+ * @param stride The size of an element of the array.
+ * @param count  The number of elements.
+ */
+void SlStridedBytes(void *ptr, size_t stride, size_t count)
+{
+	if (_sl.action == SLA_PTRS || _sl.action == SLA_NULL) return;
+
+	/* Automatically calculate the length? */
+	if (_sl.need_length != NL_NONE) {
+		SlSetLength(count);
+		/* Determine length only? */
+		if (_sl.need_length == NL_CALCLENGTH) return;
+	}
+
+	if (stride == 1) {
+		SlCopyBytes(ptr, count);
+		return;
+	}
+
+	byte *p = (byte *)ptr;
+
+	switch (_sl.action) {
+		case SLA_LOAD_CHECK:
+		case SLA_LOAD:
+			while (count != 0) {
+				size_t len = min(count, _sl.reader->GetAvailable());
+				const byte *src = _sl.reader->bufp;
+				switch (stride) {
+					case 2: ScatterBytes<2>(p, src, len); break;
+					case 4: ScatterBytes<4>(p, src, len); break;
+					case 8: ScatterBytes<8>(p, src, len); break;
+					default:
+						for (size_t i = 0; i < len; i++) p[i * stride] = src[i];
+						break;
+				}
+				_sl.reader->bufp += len;
+				p += len * stride;
+				count -= len;
+			}
+			break;
+		case SLA_SAVE:
+			while (count != 0) {
+				size_t len = min(count, _sl.dumper->GetSpace());
+				byte *dst = _sl.dumper->buf;
+				switch (stride) {
+					case 2: GatherBytes<2>(dst, p, len); break;
+					case 4: GatherBytes<4>(dst, p, len); break;
+					case 8: GatherBytes<8>(dst, p, len); break;
+					default:
+						for (size_t i = 0; i < len; i++) dst[i] = p[i * stride];
+						break;
+				}
+				_sl.dumper->buf += len;
+				p += len * stride;
+				count -= len;
+			}
+			break;
+		default: NOT_REACHED();
+	}
+}
+
+/**
+ * Save or load a uint16 from each element of an array of structures directly
+ * from or to the buffers of the savegame. In the savegame the values are
+ * stored consecutively in big endian, like SlArray with SLE_UINT16 does.
+ * @param ptr    The uint16 in the first element of the array.
+ * @param stride The size of an element of the array.
+ * @param count  The number of elements.
+ */
+void SlStridedUint16(void *ptr, size_t stride, size_t count)
+{
+	if (_sl.action == SLA_PTRS || _sl.action == SLA_NULL) return;
+
+	/* Automatically calculate the length? */
+	if (_sl.need_length != NL_NONE) {
+		SlSetLength(count * 2);
+		/* Determine length only? */
+		if (_sl.need_length == NL_CALCLENGTH) return;
+	}
+
+	byte *p = (byte *)ptr;
+
+	switch (_sl.action) {
+		case SLA_LOAD_CHECK:
+		case SLA_LOAD:
+			while (count != 0) {
+				size_t len = min(count, _sl.reader->GetAvailable() / 2);
+				if (len == 0) {
+					/* The value is split over two reads of the filter. */
+					uint16 v = SlReadByte() << 8;
+					*(uint16 *)p = v | SlReadByte();
+					p += stride;
+					count--;
+					continue;
+				}
+				const byte *src = _sl.reader->bufp;
+				for (size_t i = 0; i < len; i++) {
+					*(uint16 *)(p + i * stride) = (src[i * 2] << 8) | src[i * 2 + 1];
+				}
+				_sl.reader->bufp += len * 2;
+				p += len * stride;
+				count -= len;
+			}
+			break;
+		case SLA_SAVE:
+			while (count != 0) {
+				size_t len = min(count, _sl.dumper->GetSpace() / 2);
+				if (len == 0) {
+					/* The value is split over two blocks of the dumper. */
+					uint16 v = *(const uint16 *)p;
+					SlWriteByte(GB(v, 8, 8));
+					SlWriteByte(GB(v, 0, 8));
+					p += stride;
+					count--;
+					continue;
+				}
+				byte *dst = _sl.dumper->buf;
+				for (size_t i = 0; i < len; i++) {
+					uint16 v = *(const uint16 *)(p + i * stride);
+					dst[i * 2] = GB(v, 8, 8);
+					dst[i * 2 + 1] = GB(v, 0, 8);
+				}
+				_sl.dumper->buf += len * 2;
+				p += len * stride;
+				count -= len;
+			}
+			break;
+		default: NOT_REACHED();
+	}
+}
+
 
 /**
  * Pointers cannot be saved to a savegame, so this functions gets
@@ -1336,11 +1638,13 @@ static void *IntToReference(size_t index, SLRefType rt)
 
 /**
  * Return the size in bytes of a list
- * @param list The std::list to find the size of
+ * @tparam PtrList The type of the list of pointers.
+ * @param list The list to find the size of
  */
+template <typename PtrList>
 static inline size_t SlCalcListLen(const void *list)
 {
-	const std::list<void *> *l = (const std::list<void *> *) list;
+	const PtrList *l = (const PtrList *) list;
 
 	int type_size = IsSavegameVersionBefore(69) ? 2 : 4;
 	/* Each entry is saved as type_size bytes, plus type_size bytes are used for the length
@@ -1351,26 +1655,27 @@ static inline size_t SlCalcListLen(const void *list)
 
 /**
  * Save/Load a list.
+ * @tparam PtrList The type of the list of pointers.
  * @param list The list being manipulated
  * @param conv SLRefType type of the list (Vehicle *, Station *, etc)
  */
+template <typename PtrList>
 static void SlList(void *list, SLRefType conv)
 {
 	/* Automatically calculate the length? */
 	if (_sl.need_length != NL_NONE) {
-		SlSetLength(SlCalcListLen(list));
+		SlSetLength(SlCalcListLen<PtrList>(list));
 		/* Determine length only? */
 		if (_sl.need_length == NL_CALCLENGTH) return;
 	}
 
-	typedef std::list<void *> PtrList;
 	PtrList *l = (PtrList *)list;
 
 	switch (_sl.action) {
 		case SLA_SAVE: {
 			SlWriteUint32((uint32)l->size());
 
-			PtrList::iterator iter;
+			typename PtrList::iterator iter;
 			for (iter = l->begin(); iter != l->end(); ++iter) {
 				void *ptr = *iter;
 				SlWriteUint32((uint32)ReferenceToInt(ptr, conv));
@@ -1389,13 +1694,10 @@ static void SlList(void *list, SLRefType conv)
 			break;
 		}
 		case SLA_PTRS: {
-			PtrList temp = *l;
-
-			l->clear();
-			PtrList::iterator iter;
-			for (iter = temp.begin(); iter != temp.end(); ++iter) {
-				void *ptr = IntToReference((size_t)*iter, conv);
-				l->push_back(ptr);
+			/* Replace the indices by the pointers they refer to */
+			typename PtrList::iterator iter;
+			for (iter = l->begin(); iter != l->end(); ++iter) {
+				*iter = IntToReference((size_t)*iter, conv);
 			}
 			break;
 		}
@@ -1458,6 +1760,7 @@ size_t SlCalcObjMemberLength(const void *object, const SaveLoad *sld)
 		case SL_ARR:
 		case SL_STR:
 		case SL_LST:
+		case SL_DEQUE:
 			/* CONDITIONAL saveload types depend on the savegame version */
 			if (!SlIsObjectValidInSavegame(sld)) break;
 
@@ -1466,7 +1769,8 @@ size_t SlCalcObjMemberLength(const void *object, const SaveLoad *sld)
 				case SL_REF: return SlCalcRefLen();
 				case SL_ARR: return SlCalcArrayLen(sld->length, sld->conv);
 				case SL_STR: return SlCalcStringLen(GetVariableAddress(object, sld), sld->length, sld->conv);
-				case SL_LST: return SlCalcListLen(GetVariableAddress(object, sld));
+				case SL_LST: return SlCalcListLen<std::list<void *> >(GetVariableAddress(object, sld));
+				case SL_DEQUE: return SlCalcListLen<SmallDeque<void *> >(GetVariableAddress(object, sld));
 				default: NOT_REACHED();
 			}
 			break;
@@ -1488,6 +1792,7 @@ bool SlObjectMember(void *ptr, const SaveLoad *sld)
 		case SL_ARR:
 		case SL_STR:
 		case SL_LST:
+		case SL_DEQUE:
 			/* CONDITIONAL saveload types depend on the savegame version */
 			if (!SlIsObjectValidInSavegame(sld)) return false;
 			if (SlSkipVariableOnLoad(sld)) return false;
@@ -1514,7 +1819,8 @@ bool SlObjectMember(void *ptr, const SaveLoad *sld)
 					break;
 				case SL_ARR: SlArray(ptr, sld->length, conv); break;
 				case SL_STR: SlString(ptr, sld->length, sld->conv); break;
-				case SL_LST: SlList(ptr, (SLRefType)conv); break;
+				case SL_LST: SlList<std::list<void *> >(ptr, (SLRefType)conv); break;
+				case SL_DEQUE: SlList<SmallDeque<void *> >(ptr, (SLRefType)conv); break;
 				default: NOT_REACHED();
 			}
 			break;
@@ -1568,6 +1874,303 @@ void SlObject(void *object, const SaveLoad *sld)
 	}
 }
 
+/**
+ * Write a value in big endian to the savegame. When the current block of the
+ * dumper has room for the whole value it is written directly into the block.
+ * @tparam Tsize The number of bytes of the value in the savegame.
+ * @param x The value to write.
+ */
+template <size_t Tsize>
+static inline void SlWriteBigEndian(uint64 x)
+{
+	MemoryDumper *dumper = _sl.dumper;
+	if ((size_t)(dumper->bufe - dumper->buf) < Tsize) {
+		for (size_t i = Tsize; i-- > 0;) SlWriteByte(GB(x, i * 8, 8));
+		return;
+	}
+
+	for (size_t i = 0; i < Tsize; i++) dumper->buf[i] = GB(x, (Tsize - 1 - i) * 8, 8);
+	dumper->buf += Tsize;
+}
+
+/**
+ * Read a value in big endian from the savegame. When the buffer of the reader
+ * contains the whole value it is read directly from the buffer.
+ * @tparam Tsize The number of bytes of the value in the savegame.
+ * @return The read value.
+ */
+template <size_t Tsize>
+static inline uint64 SlReadBigEndian()
+{
+	ReadBuffer *reader = _sl.reader;
+	uint64 x = 0;
+	if ((size_t)(reader->bufe - reader->bufp) < Tsize) {
+		for (size_t i = 0; i < Tsize; i++) x = (x << 8) | SlReadByte();
+		return x;
+	}
+
+	for (size_t i = 0; i < Tsize; i++) x = (x << 8) | reader->bufp[i];
+	reader->bufp += Tsize;
+	return x;
+}
+
+/** Function to save or load a single field of a compiled SaveLoad description. */
+typedef void SlCompiledFieldProc(void *ptr, const SaveLoad *sld);
+
+/**
+ * Save a numeric variable without interpreting its #VarType.
+ * @tparam Tmem  The type of the variable in memory.
+ * @tparam Tfile The type of the variable in the savegame.
+ * @param ptr The variable.
+ * @param sld The description of the variable.
+ */
+template <typename Tmem, typename Tfile>
+static void SlSaveCompiledVar(void *ptr, const SaveLoad *sld)
+{
+	int64 x = *(const Tmem *)ptr;
+	/* Like SlSaveLoadConv, only check the range of the smaller types. */
+	assert(sizeof(Tfile) >= 4 || (int64)(Tfile)x == x);
+	SlWriteBigEndian<sizeof(Tfile)>((uint64)x);
+}
+
+/**
+ * Load a numeric variable without interpreting its #VarType.
+ * @tparam Tmem  The type of the variable in memory.
+ * @tparam Tfile The type of the variable in the savegame.
+ * @param ptr The variable.
+ * @param sld The description of the variable.
+ */
+template <typename Tmem, typename Tfile>
+static void SlLoadCompiledVar(void *ptr, const SaveLoad *sld)
+{
+	*(Tmem *)ptr = (Tmem)(Tfile)SlReadBigEndian<sizeof(Tfile)>();
+}
+
+/**
+ * Save a reference in the current savegame version.
+ * @param ptr The reference.
+ * @param sld The description of the reference.
+ */
+static void SlSaveCompiledRef(void *ptr, const SaveLoad *sld)
+{
+	SlWriteBigEndian<4>((uint32)ReferenceToInt(*(void **)ptr, (SLRefType)GB(sld->conv, 0, 8)));
+}
+
+/**
+ * Load a reference in the current savegame version.
+ * @param ptr The reference.
+ * @param sld The description of the reference.
+ */
+static void SlLoadCompiledRef(void *ptr, const SaveLoad *sld)
+{
+	*(size_t *)ptr = (uint32)SlReadBigEndian<4>();
+}
+
+/** A field of a SaveLoad description that is stored in the current savegame version. */
+struct SaveLoadCompiledField {
+	const SaveLoad *sld;       ///< The description of the field.
+	SlCompiledFieldProc *save; ///< Specialised function to save the field, or \c NULL to use SlObjectMember.
+	SlCompiledFieldProc *load; ///< Specialised function to load the field, or \c NULL to use SlObjectMember.
+	bool pointers;             ///< Whether the field has to be handled when fixing or clearing pointers.
+};
+
+/**
+ * A SaveLoad description prepared for the current savegame version. The
+ * conditions on the savegame version are resolved, included descriptions
+ * are flattened and the numeric variables and references get a function
+ * specialised for their types, so the #VarType is not interpreted for
+ * every object again.
+ */
+struct SaveLoadCompiled {
+	const SaveLoad *desc;                          ///< The description this is compiled from.
+	SmallVector<SaveLoadCompiledField, 64> fields; ///< The fields in the current savegame version.
+	size_t fixed_length;                           ///< Length in the savegame of the fields with specialised functions.
+
+	/**
+	 * Compile a description.
+	 * @param desc The description.
+	 */
+	SaveLoadCompiled(const SaveLoad *desc) : desc(desc), fixed_length(0)
+	{
+		this->Add(desc);
+	}
+
+	/**
+	 * Select the functions for a numeric variable.
+	 * @tparam Tmem The type of the variable in memory.
+	 * @param field The field to select the functions for.
+	 * @param file  The type of the variable in the savegame.
+	 * @return True iff there are specialised functions for the variable.
+	 */
+	template <typename Tmem>
+	static bool SetVarProcs(SaveLoadCompiledField *field, VarType file)
+	{
+		switch (file) {
+			case SLE_FILE_I8:  field->save = &SlSaveCompiledVar<Tmem, int8>;   field->load = &SlLoadCompiledVar<Tmem, int8>;   return true;
+			case SLE_FILE_U8:  field->save = &SlSaveCompiledVar<Tmem, uint8>;  field->load = &SlLoadCompiledVar<Tmem, uint8>;  return true;
+			case SLE_FILE_I16: field->save = &SlSaveCompiledVar<Tmem, int16>;  field->load = &SlLoadCompiledVar<Tmem, int16>;  return true;
+			case SLE_FILE_U16: field->save = &SlSaveCompiledVar<Tmem, uint16>; field->load = &SlLoadCompiledVar<Tmem, uint16>; return true;
+			case SLE_FILE_I32: field->save = &SlSaveCompiledVar<Tmem, int32>;  field->load = &SlLoadCompiledVar<Tmem, int32>;  return true;
+			case SLE_FILE_U32: field->save = &SlSaveCompiledVar<Tmem, uint32>; field->load = &SlLoadCompiledVar<Tmem, uint32>; return true;
+			case SLE_FILE_I64: field->save = &SlSaveCompiledVar<Tmem, int64>;  field->load = &SlLoadCompiledVar<Tmem, int64>;  return true;
+			case SLE_FILE_U64: field->save = &SlSaveCompiledVar<Tmem, uint64>; field->load = &SlLoadCompiledVar<Tmem, uint64>; return true;
+			/* String IDs have to be remapped when loading. */
+			default: return false;
+		}
+	}
+
+	/**
+	 * Add the fields of a description that are in the current savegame version.
+	 * @param sld The description.
+	 */
+	void Add(const SaveLoad *sld)
+	{
+		for (; sld->cmd != SL_END; sld++) {
+			switch (sld->cmd) {
+				case SL_VEH_INCLUDE: this->Add(GetVehicleDescription(VEH_END)); continue;
+				case SL_ST_INCLUDE: this->Add(GetBaseStationDescription()); continue;
+				case SL_WRITEBYTE: break;
+				default:
+					if (!SlIsObjectValidInSavegame(sld)) continue;
+					break;
+			}
+
+			SaveLoadCompiledField *field = this->fields.Append();
+			field->sld = sld;
+			field->save = NULL;
+			field->load = NULL;
+			field->pointers = sld->cmd == SL_REF || sld->cmd == SL_LST || sld->cmd == SL_DEQUE;
+
+			/* Variables that are not synced over the network are skipped depending on the action. */
+			if (sld->conv & SLF_NO_NETWORK_SYNC) continue;
+
+			VarType conv = GB(sld->conv, 0, 8);
+			bool specialised = false;
+			switch (sld->cmd) {
+				case SL_VAR:
+					switch (GetVarMemType(conv)) {
+						case SLE_VAR_BL:  specialised = SetVarProcs<bool>(field, GetVarFileType(conv));   break;
+						case SLE_VAR_I8:  specialised = SetVarProcs<int8>(field, GetVarFileType(conv));   break;
+						case SLE_VAR_U8:  specialised = SetVarProcs<uint8>(field, GetVarFileType(conv));  break;
+						case SLE_VAR_I16: specialised = SetVarProcs<int16>(field, GetVarFileType(conv));  break;
+						case SLE_VAR_U16: specialised = SetVarProcs<uint16>(field, GetVarFileType(conv)); break;
+						case SLE_VAR_I32: specialised = SetVarProcs<int32>(field, GetVarFileType(conv));  break;
+						case SLE_VAR_U32: specialised = SetVarProcs<uint32>(field, GetVarFileType(conv)); break;
+						case SLE_VAR_I64: specialised = SetVarProcs<int64>(field, GetVarFileType(conv));  break;
+						case SLE_VAR_U64: specialised = SetVarProcs<uint64>(field, GetVarFileType(conv)); break;
+						default: break;
+					}
+					if (specialised) this->fixed_length += SlCalcConvFileLen(conv);
+					break;
+
+				case SL_REF:
+					field->save = &SlSaveCompiledRef;
+					field->load = &SlLoadCompiledRef;
+					this->fixed_length += SlCalcRefLen();
+					break;
+
+				default: break;
+			}
+		}
+	}
+
+	/**
+	 * Calculate the length of an object in the savegame.
+	 * @param object The object.
+	 * @return The length.
+	 */
+	size_t CalcLength(const void *object) const
+	{
+		size_t length = this->fixed_length;
+		for (const SaveLoadCompiledField *field = this->fields.Begin(); field != this->fields.End(); field++) {
+			if (field->save == NULL) length += SlCalcObjMemberLength(object, field->sld);
+		}
+		return length;
+	}
+
+	/**
+	 * Save or load an object, or fix or clear its pointers.
+	 * @param object The object.
+	 */
+	void Run(void *object) const
+	{
+		switch (_sl.action) {
+			case SLA_SAVE:
+				for (const SaveLoadCompiledField *field = this->fields.Begin(); field != this->fields.End(); field++) {
+					void *ptr = field->sld->global ? field->sld->address : GetVariableAddress(object, field->sld);
+					if (field->save != NULL) {
+						field->save(ptr, field->sld);
+					} else {
+						SlObjectMember(ptr, field->sld);
+					}
+				}
+				break;
+
+			case SLA_LOAD_CHECK:
+			case SLA_LOAD:
+				for (const SaveLoadCompiledField *field = this->fields.Begin(); field != this->fields.End(); field++) {
+					void *ptr = field->sld->global ? field->sld->address : GetVariableAddress(object, field->sld);
+					if (field->load != NULL) {
+						field->load(ptr, field->sld);
+					} else {
+						SlObjectMember(ptr, field->sld);
+					}
+				}
+				break;
+
+			case SLA_PTRS:
+			case SLA_NULL:
+				for (const SaveLoadCompiledField *field = this->fields.Begin(); field != this->fields.End(); field++) {
+					if (!field->pointers) continue;
+					void *ptr = field->sld->global ? field->sld->address : GetVariableAddress(object, field->sld);
+					SlObjectMember(ptr, field->sld);
+				}
+				break;
+
+			default: NOT_REACHED();
+		}
+	}
+};
+
+/** The descriptions compiled so far; they stay valid as the descriptions are static. */
+static AutoDeleteSmallVector<SaveLoadCompiled *, 16> _sl_compiled;
+
+/**
+ * Main SaveLoad function for the objects of the big chunks. It does the same
+ * as SlObject, but the description is compiled once for the current savegame
+ * version so the fields are not interpreted for every object. Savegames of
+ * older versions use SlObject.
+ * @param object The object that is being saved or loaded
+ * @param sld The SaveLoad description of the object; it must not be changed after it was used once.
+ */
+void SlCompiledObject(void *object, const SaveLoad *sld)
+{
+	if (_sl_version != SAVEGAME_VERSION) {
+		SlObject(object, sld);
+		return;
+	}
+
+	const SaveLoadCompiled *compiled = NULL;
+	for (SaveLoadCompiled **it = _sl_compiled.Begin(); it != _sl_compiled.End(); it++) {
+		if ((*it)->desc == sld) {
+			compiled = *it;
+			break;
+		}
+	}
+	if (compiled == NULL) {
+		compiled = new SaveLoadCompiled(sld);
+		*_sl_compiled.Append() = const_cast<SaveLoadCompiled *>(compiled);
+	}
+
+	/* Automatically calculate the length? */
+	if (_sl.need_length != NL_NONE) {
+		SlSetLength(compiled->CalcLength(object));
+		if (_sl.need_length == NL_CALCLENGTH) return;
+	}
+
+	compiled->Run(object);
+}
+
 /**
  * Save or Load (a list of) global variables
  * @param sldg The global variable that is being loaded or saved
@@ -1730,6 +2333,10 @@ static void SlSaveChunk(const ChunkHandler *ch)
 	/* Don't save any chunk information if there is no save handler. */
 	if (proc == NULL) return;
 
+	ChunkIndexEntry *entry = _sl.dumper->chunks.Append();
+	entry->id = ch->id;
+	entry->offset = _sl.dumper->GetSize();
+
 	SlWriteUint32(ch->id);
 	DEBUG(sl, 2, "Saving chunk %c%c%c%c", ch->id >> 24, ch->id >> 16, ch->id >> 8, ch->id);
 
@@ -1760,28 +2367,124 @@ static void SlSaveChunk(const ChunkHandler *ch)
 	}
 }
 
-/** Save all chunks */
-static void SlSaveChunks()
+/** Time and size of saving and loading a chunk, for the savegame benchmark. */
+struct ChunkTiming {
+	uint32 id;        ///< The chunk.
+	uint64 save_time; ///< Total time spent saving the chunk, in microseconds.
+	uint64 load_time; ///< Total time spent loading the chunk, in microseconds.
+	size_t bytes;     ///< Size of the chunk in the uncompressed savegame, when it was saved last.
+};
+
+/** Timings of the chunks when the savegame benchmark is running, otherwise \c NULL. */
+static SmallVector<ChunkTiming, 64> *_chunk_timings = NULL;
+
+/**
+ * Get the timing of a chunk for the savegame benchmark.
+ * @param id The chunk.
+ * @return The timing.
+ */
+static ChunkTiming *GetChunkTiming(uint32 id)
 {
-	FOR_ALL_CHUNK_HANDLERS(ch) {
-		SlSaveChunk(ch);
+	for (ChunkTiming *t = _chunk_timings->Begin(); t != _chunk_timings->End(); t++) {
+		if (t->id == id) return t;
 	}
 
-	/* Terminator */
-	SlWriteUint32(0);
+	ChunkTiming *t = _chunk_timings->Append();
+	t->id = id;
+	t->save_time = 0;
+	t->load_time = 0;
+	t->bytes = 0;
+	return t;
 }
 
 /**
- * Find the ChunkHandler that will be used for processing the found
- * chunk in the savegame or in memory
- * @param id the chunk in question
- * @return returns the appropriate chunkhandler
+ * Save the chunks that run scripts to a dumper of their own, before the other
+ * chunks are saved. #SlSaveChunks copies them into the savegame at their place.
  */
-static const ChunkHandler *SlFindChunkHandler(uint32 id)
+static void SlPresaveChunks()
 {
-	FOR_ALL_CHUNK_HANDLERS(ch) if (ch->id == id) return ch;
-	return NULL;
-}
+	MemoryDumper *dumper = _sl.dumper;
+	_sl.presaved = new MemoryDumper();
+	_sl.dumper = _sl.presaved;
+	try {
+		FOR_ALL_CHUNK_HANDLERS(ch) {
+			if (ch->flags & CH_RUNS_SCRIPTS) SlSaveChunk(ch);
+		}
+	} catch (...) {
+		_sl.dumper = dumper;
+		throw;
+	}
+	_sl.dumper = dumper;
+}
+
+/**
+ * Copy a chunk that has been saved by #SlPresaveChunks into the savegame.
+ * @param ch The chunk to copy.
+ */
+static void SlCopyPresavedChunk(const ChunkHandler *ch)
+{
+	const SmallVector<ChunkIndexEntry, 64> &chunks = _sl.presaved->chunks;
+	for (uint i = 0; i < chunks.Length(); i++) {
+		if (chunks[i].id != ch->id) continue;
+
+		ChunkIndexEntry *entry = _sl.dumper->chunks.Append();
+		entry->id = ch->id;
+		entry->offset = _sl.dumper->GetSize();
+
+		size_t offset = (size_t)chunks[i].offset;
+		size_t len = (i + 1 < chunks.Length() ? (size_t)chunks[i + 1].offset : _sl.presaved->GetSize()) - offset;
+		byte buf[4096];
+		while (len > 0) {
+			size_t to_copy = min(len, sizeof(buf));
+			_sl.presaved->CopyTo(offset, buf, to_copy);
+			_sl.dumper->Write(buf, to_copy);
+			offset += to_copy;
+			len -= to_copy;
+		}
+		return;
+	}
+}
+
+/** Save all chunks */
+static void SlSaveChunks()
+{
+	FOR_ALL_CHUNK_HANDLERS(ch) {
+		if (_sl.presaved != NULL && (ch->flags & CH_RUNS_SCRIPTS)) {
+			SlCopyPresavedChunk(ch);
+			continue;
+		}
+
+		if (_chunk_timings == NULL) {
+			SlSaveChunk(ch);
+			continue;
+		}
+
+		uint64 start = GetTickProfilerTime();
+		size_t size = _sl.dumper->GetSize();
+		SlSaveChunk(ch);
+		ChunkTiming *t = GetChunkTiming(ch->id);
+		t->save_time += GetTickProfilerTime() - start;
+		t->bytes = _sl.dumper->GetSize() - size;
+	}
+
+	/* Terminator */
+	ChunkIndexEntry *entry = _sl.dumper->chunks.Append();
+	entry->id = 0;
+	entry->offset = _sl.dumper->GetSize();
+	SlWriteUint32(0);
+}
+
+/**
+ * Find the ChunkHandler that will be used for processing the found
+ * chunk in the savegame or in memory
+ * @param id the chunk in question
+ * @return returns the appropriate chunkhandler
+ */
+static const ChunkHandler *SlFindChunkHandler(uint32 id)
+{
+	FOR_ALL_CHUNK_HANDLERS(ch) if (ch->id == id) return ch;
+	return NULL;
+}
 
 /** Load all chunks */
 static void SlLoadChunks()
@@ -1794,7 +2497,15 @@ static void SlLoadChunks()
 
 		ch = SlFindChunkHandler(id);
 		if (ch == NULL) SlErrorCorrupt("Unknown chunk type");
+
+		if (_chunk_timings == NULL) {
+			SlLoadChunk(ch);
+			continue;
+		}
+
+		uint64 start = GetTickProfilerTime();
 		SlLoadChunk(ch);
+		GetChunkTiming(id)->load_time += GetTickProfilerTime() - start;
 	}
 }
 
@@ -1835,20 +2546,28 @@ static void SlFixPointers()
 
 /** Yes, simply reading from a file. */
 struct FileReader : LoadFilter {
-	FILE *file; ///< The file to read from.
-	long begin; ///< The begin of the file.
+	FILE *file;  ///< The file to read from.
+	long begin;  ///< The begin of the file.
+	byte *map;   ///< The file mapped into memory, or \c NULL to read it with fread.
+	size_t size; ///< The size of #map.
+	size_t pos;  ///< Position in #map.
 
 	/**
 	 * Create the file reader, so it reads from a specific file.
 	 * @param file The file to read from.
 	 */
-	FileReader(FILE *file) : LoadFilter(NULL), file(file), begin(ftell(file))
+	FileReader(FILE *file) : LoadFilter(NULL), file(file), begin(ftell(file)), pos(begin)
 	{
+		/* Uncompressed savegames are then served directly from the page cache. */
+		this->map = FioMapFile(file, &this->size);
 	}
 
 	/** Make sure everything is cleaned up. */
 	~FileReader()
 	{
+		if (this->map != NULL) FioUnmapFile(this->map, this->size);
+		this->map = NULL;
+
 		if (this->file != NULL) fclose(this->file);
 		this->file = NULL;
 
@@ -1861,11 +2580,21 @@ struct FileReader : LoadFilter {
 		/* We're in the process of shutting down, i.e. in "failure" mode. */
 		if (this->file == NULL) return 0;
 
+		if (this->map != NULL) {
+			if (this->pos >= this->size) return 0;
+			size = min(size, this->size - this->pos);
+			memcpy(buf, this->map + this->pos, size);
+			this->pos += size;
+			return size;
+		}
+
 		return fread(buf, 1, size, this->file);
 	}
 
 	/* virtual */ void Reset()
 	{
+		this->pos = this->begin;
+
 		clearerr(this->file);
 		if (fseek(this->file, this->begin, SEEK_SET)) {
 			DEBUG(sl, 1, "Could not reset the file reading");
@@ -2279,217 +3008,1641 @@ struct LZMASaveFilter : SaveFilter {
 
 #endif /* WITH_LZMA */
 
-/*******************************************
- ************* END OF CODE *****************
- *******************************************/
-
-/** The format for a reader/writer type of a savegame */
-struct SaveLoadFormat {
-	const char *name;                     ///< name of the compressor/decompressor (debug-only)
-	uint32 tag;                           ///< the 4-letter tag by which it is identified in the savegame
-
-	LoadFilter *(*init_load)(LoadFilter *chain);                    ///< Constructor for the load filter.
-	SaveFilter *(*init_write)(SaveFilter *chain, byte compression); ///< Constructor for the save filter.
-
-	byte min_compression;                 ///< the minimum compression level of this format
-	byte default_compression;             ///< the default compression level of this format
-	byte max_compression;                 ///< the maximum compression level of this format
-};
-
-/** The different saveload formats known/understood by OpenTTD. */
-static const SaveLoadFormat _saveload_formats[] = {
-#if defined(WITH_LZO)
-	/* Roughly 75% larger than zlib level 6 at only ~7% of the CPU usage. */
-	{"lzo",    TO_BE32X('OTTD'), CreateLoadFilter<LZOLoadFilter>,    CreateSaveFilter<LZOSaveFilter>,    0, 0, 0},
-#else
-	{"lzo",    TO_BE32X('OTTD'), NULL,                               NULL,                               0, 0, 0},
-#endif
-	/* Roughly 5 times larger at only 1% of the CPU usage over zlib level 6. */
-	{"none",   TO_BE32X('OTTN'), CreateLoadFilter<NoCompLoadFilter>, CreateSaveFilter<NoCompSaveFilter>, 0, 0, 0},
-#if defined(WITH_ZLIB)
-	/* After level 6 the speed reduction is significant (1.5x to 2.5x slower per level), but the reduction in filesize is
-	 * fairly insignificant (~1% for each step). Lower levels become ~5-10% bigger by each level than level 6 while level
-	 * 1 is "only" 3 times as fast. Level 0 results in uncompressed savegames at about 8 times the cost of "none". */
-	{"zlib",   TO_BE32X('OTTZ'), CreateLoadFilter<ZlibLoadFilter>,   CreateSaveFilter<ZlibSaveFilter>,   0, 6, 9},
-#else
-	{"zlib",   TO_BE32X('OTTZ'), NULL,                               NULL,                               0, 0, 0},
-#endif
-#if defined(WITH_LZMA)
-	/* Level 2 compression is speed wise as fast as zlib level 6 compression (old default), but results in ~10% smaller saves.
-	 * Higher compression levels are possible, and might improve savegame size by up to 25%, but are also up to 10 times slower.
-	 * The next significant reduction in file size is at level 4, but that is already 4 times slower. Level 3 is primarily 50%
-	 * slower while not improving the filesize, while level 0 and 1 are faster, but don't reduce savegame size much.
-	 * It's OTTX and not e.g. OTTL because liblzma is part of xz-utils and .tar.xz is preferred over .tar.lzma. */
-	{"lzma",   TO_BE32X('OTTX'), CreateLoadFilter<LZMALoadFilter>,   CreateSaveFilter<LZMASaveFilter>,   0, 2, 9},
-#else
-	{"lzma",   TO_BE32X('OTTX'), NULL,                               NULL,                               0, 0, 0},
-#endif
-};
+/********************************************
+ ********** START OF BLOCK CODE *************
+ ********************************************/
 
-/**
- * Return the savegameformat of the game. Whether it was created with ZLIB compression
- * uncompressed, or another type
- * @param s Name of the savegame format. If NULL it picks the first available one
- * @param compression_level Output for telling what compression level we want.
- * @return Pointer to SaveLoadFormat struct giving all characteristics of this type of savegame
+/*
+ * The block formats split the savegame into blocks that are compressed
+ * independently of each other, so a pool of worker threads can compress
+ * or decompress several blocks at once. After the savegame header comes
+ * the tag of the compression used for the blocks; every block then starts
+ * with its uncompressed and compressed size, both big endian uint32. A
+ * block with an uncompressed size of 0 ends the savegame.
+ *
+ * The blocks are followed by the chunk index: the tag 'OTTI', the number of
+ * blocks and the offset of each block, the number of chunks and for each
+ * chunk its id and the offset of that id in the uncompressed savegame. The
+ * last chunk of the index is the terminator with id 0. The savegame ends
+ * with the offset of the chunk index and again the tag 'OTTI'. The offsets
+ * are big endian uint64, so they do not overflow for savegames of more than
+ * 4 GiB, and all other numbers big endian uint32; the offsets of the blocks
+ * and the chunk index count from the codec tag. Every block but the last holds exactly BLOCK_SIZE
+ * bytes, so a chunk can be read by decompressing only the blocks it is in.
  */
-static const SaveLoadFormat *GetSavegameFormat(char *s, byte *compression_level)
-{
-	const SaveLoadFormat *def = lastof(_saveload_formats);
-
-	/* find default savegame format, the highest one with which files can be written */
-	while (!def->init_write) def--;
-
-	if (!StrEmpty(s)) {
-		/* Get the ":..." of the compression level out of the way */
-		char *complevel = strrchr(s, ':');
-		if (complevel != NULL) *complevel = '\0';
 
-		for (const SaveLoadFormat *slf = &_saveload_formats[0]; slf != endof(_saveload_formats); slf++) {
-			if (slf->init_write != NULL && strcmp(s, slf->name) == 0) {
-				*compression_level = slf->default_compression;
-				if (complevel != NULL) {
-					/* There is a compression level in the string.
-					 * First restore the : we removed to do proper name matching,
-					 * then move the the begin of the actual version. */
-					*complevel = ':';
-					complevel++;
+/** Amount of uncompressed data in a single block. */
+static const size_t BLOCK_SIZE = 2 * 1024 * 1024;
 
-					/* Get the version and determine whether all went fine. */
-					char *end;
-					long level = strtol(complevel, &end, 10);
-					if (end == complevel || level != Clamp(level, slf->min_compression, slf->max_compression)) {
-						SetDParamStr(0, complevel);
-						ShowErrorMessage(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_SAVEGAME_COMPRESSION_LEVEL, WL_CRITICAL);
-					} else {
-						*compression_level = level;
-					}
-				}
-				return slf;
-			}
-		}
+/** Compression of the blocks of the block formats. */
+struct BlockCodec {
+	uint32 tag; ///< The tag by which the compression is identified in the savegame.
 
-		SetDParamStr(0, s);
-		SetDParamStr(1, def->name);
-		ShowErrorMessage(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_SAVEGAME_COMPRESSION_ALGORITHM, WL_CRITICAL);
+	/**
+	 * Get the maximum size of the compressed data.
+	 * @param len Size of the uncompressed data.
+	 * @return Worst case size of the compressed data.
+	 */
+	size_t (*bound)(size_t len);
 
-		/* Restore the string by adding the : back */
-		if (complevel != NULL) *complevel = ':';
-	}
-	*compression_level = def->default_compression;
-	return def;
-}
+	/**
+	 * Compress a block.
+	 * @param in      The uncompressed data.
+	 * @param in_len  Size of the uncompressed data.
+	 * @param out     Buffer for the compressed data, of at least bound(in_len) bytes.
+	 * @param out_len Output for the size of the compressed data.
+	 * @param level   The requested level of compression.
+	 * @return Whether compressing succeeded.
+	 */
+	bool (*compress)(const byte *in, size_t in_len, byte *out, size_t *out_len, byte level);
 
-/* actual loader/saver function */
-void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settings);
-extern bool AfterLoadGame();
-extern bool LoadOldSaveGame(const char *file);
+	/**
+	 * Decompress a block.
+	 * @param in      The compressed data.
+	 * @param in_len  Size of the compressed data.
+	 * @param out     Buffer for the uncompressed data.
+	 * @param out_len Size of the uncompressed data, as stored in the savegame.
+	 * @return Whether decompressing succeeded and yielded exactly out_len bytes.
+	 */
+	bool (*decompress)(const byte *in, size_t in_len, byte *out, size_t out_len);
+};
 
-/**
- * Clear/free saveload state.
- */
-static inline void ClearSaveLoadState()
+#if defined(WITH_ZLIB)
+static size_t ZlibBlockBound(size_t len)
 {
-	delete _sl.dumper;
-	_sl.dumper = NULL;
-
-	delete _sl.sf;
-	_sl.sf = NULL;
-
-	delete _sl.reader;
-	_sl.reader = NULL;
-
-	delete _sl.lf;
-	_sl.lf = NULL;
+	return compressBound((uLong)len);
 }
 
-/**
- * Update the gui accordingly when starting saving
- * and set locks on saveload. Also turn off fast-forward cause with that
- * saving takes Aaaaages
- */
-static void SaveFileStart()
+static bool ZlibBlockCompress(const byte *in, size_t in_len, byte *out, size_t *out_len, byte level)
 {
-	_sl.ff_state = _fast_forward;
-	_fast_forward = 0;
-	if (_cursor.sprite == SPR_CURSOR_MOUSE) SetMouseCursor(SPR_CURSOR_ZZZ, PAL_NONE);
-
-	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_START);
-	_sl.saveinprogress = true;
+	uLongf len = (uLongf)ZlibBlockBound(in_len);
+	if (compress2(out, &len, in, (uLong)in_len, level) != Z_OK) return false;
+	*out_len = len;
+	return true;
 }
 
-/** Update the gui accordingly when saving is done and release locks on saveload. */
-static void SaveFileDone()
+static bool ZlibBlockDecompress(const byte *in, size_t in_len, byte *out, size_t out_len)
 {
-	if (_game_mode != GM_MENU) _fast_forward = _sl.ff_state;
-	if (_cursor.sprite == SPR_CURSOR_ZZZ) SetMouseCursor(SPR_CURSOR_MOUSE, PAL_NONE);
-
-	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_FINISH);
-	_sl.saveinprogress = false;
+	uLongf len = (uLongf)out_len;
+	return uncompress(out, &len, in, (uLong)in_len) == Z_OK && len == out_len;
 }
 
-/** Set the error message from outside of the actual loading/saving of the game (AfterLoadGame and friends) */
-void SetSaveLoadError(StringID str)
+/** Zlib compression of blocks. */
+static const BlockCodec _zlib_block_codec = { TO_BE32X('OTTZ'), ZlibBlockBound, ZlibBlockCompress, ZlibBlockDecompress };
+#endif /* WITH_ZLIB */
+
+#if defined(WITH_LZMA)
+static size_t LZMABlockBound(size_t len)
 {
-	_sl.error_str = str;
+	return lzma_stream_buffer_bound(len);
 }
 
-/** Get the string representation of the error message */
-const char *GetSaveLoadErrorString()
+static bool LZMABlockCompress(const byte *in, size_t in_len, byte *out, size_t *out_len, byte level)
 {
-	SetDParam(0, _sl.error_str);
-	SetDParamStr(1, _sl.extra_msg);
-
-	static char err_str[512];
-	GetString(err_str, _sl.action == SLA_SAVE ? STR_ERROR_GAME_SAVE_FAILED : STR_ERROR_GAME_LOAD_FAILED, lastof(err_str));
-	return err_str;
+	*out_len = 0;
+	return lzma_easy_buffer_encode(level, LZMA_CHECK_CRC32, NULL, in, in_len, out, out_len, LZMABlockBound(in_len)) == LZMA_OK;
 }
 
-/** Show a gui message when saving has failed */
-static void SaveFileError()
+static bool LZMABlockDecompress(const byte *in, size_t in_len, byte *out, size_t out_len)
 {
-	SetDParamStr(0, GetSaveLoadErrorString());
-	ShowErrorMessage(STR_JUST_RAW_STRING, INVALID_STRING_ID, WL_ERROR);
-	SaveFileDone();
+	/* Same limit as the LZMALoadFilter; a block is far smaller anyway. */
+	uint64_t memlimit = 1 << 28;
+	size_t in_pos = 0;
+	size_t out_pos = 0;
+	return lzma_stream_buffer_decode(&memlimit, 0, NULL, in, &in_pos, in_len, out, &out_pos, out_len) == LZMA_OK && out_pos == out_len;
 }
 
-/**
- * We have written the whole game into memory, _memory_savegame, now find
- * and appropriate compressor and start writing to file.
- */
-static SaveOrLoadResult SaveFileToDisk(bool threaded)
-{
-	try {
-		byte compression;
-		const SaveLoadFormat *fmt = GetSavegameFormat(_savegame_format, &compression);
+/** LZMA compression of blocks. */
+static const BlockCodec _lzma_block_codec = { TO_BE32X('OTTX'), LZMABlockBound, LZMABlockCompress, LZMABlockDecompress };
+#endif /* WITH_LZMA */
 
-		/* We have written our stuff to memory, now write it to file! */
-		uint32 hdr[2] = { fmt->tag, TO_BE32(SAVEGAME_VERSION << 16) };
-		_sl.sf->Write((byte*)hdr, sizeof(hdr));
+/** All compressions the blocks can be stored with. */
+static const BlockCodec * const _block_codecs[] = {
+#if defined(WITH_ZLIB)
+	&_zlib_block_codec,
+#endif
+#if defined(WITH_LZMA)
+	&_lzma_block_codec,
+#endif
+	NULL, // Keep the array non-empty when neither is available.
+};
 
-		_sl.sf = fmt->init_write(_sl.sf, compression);
-		_sl.dumper->Flush(_sl.sf);
+/** A block of the savegame that is (to be) compressed or decompressed. */
+struct SaveLoadBlock {
+	byte *in;      ///< The data to compress or decompress.
+	size_t in_len; ///< Size of #in.
+	byte *out;     ///< The compressed or decompressed data.
+	size_t out_len; ///< Size of #out; for decompression the expected size.
+	bool done;     ///< Whether #out is ready.
+	bool failed;   ///< Whether compressing or decompressing failed.
 
-		ClearSaveLoadState();
+	/**
+	 * Create a block.
+	 * @param in_len  Size of the data to compress or decompress.
+	 * @param out_len Size of the buffer for the result.
+	 */
+	SaveLoadBlock(size_t in_len, size_t out_len) : in(MallocT<byte>(in_len)), in_len(in_len), out(MallocT<byte>(out_len)), out_len(out_len), done(false), failed(false)
+	{
+	}
 
-		if (threaded) SetAsyncSaveFinish(SaveFileDone);
+	~SaveLoadBlock()
+	{
+		free(this->in);
+		free(this->out);
+	}
+};
 
-		return SL_OK;
-	} catch (...) {
-		ClearSaveLoadState();
+/**
+ * Pool of threads that compress or decompress blocks, in the order in which
+ * they are submitted. Without threads the blocks are handled on submission.
+ */
+class SaveLoadBlockWorkers {
+	const BlockCodec *codec;                   ///< The compression to use.
+	bool compress;                             ///< Whether to compress instead of decompress.
+	byte level;                                ///< The level of compression.
 
-		AsyncSaveFinishProc asfp = SaveFileDone;
+	ThreadMutex *queue_mutex;                  ///< Guards #queue and #exit; signalled when a block is queued.
+	ThreadMutex *done_mutex;                   ///< Guards SaveLoadBlock::done; signalled when a block is done.
+	SmallDeque<SaveLoadBlock *> queue;         ///< Blocks waiting for a worker.
+	SmallVector<ThreadObject *, 8> threads;    ///< The worker threads.
+	bool exit;                                 ///< Whether the workers have to stop.
 
-		/* We don't want to shout when saving is just
-		 * cancelled due to a client disconnecting. */
-		if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
-			/* Skip the "colour" character */
-			DEBUG(sl, 0, "%s", GetSaveLoadErrorString() + 3);
-			asfp = SaveFileError;
+	/**
+	 * Compress or decompress a block.
+	 * @param b The block.
+	 */
+	void Process(SaveLoadBlock *b)
+	{
+		if (this->compress) {
+			b->failed = !this->codec->compress(b->in, b->in_len, b->out, &b->out_len, this->level);
+		} else {
+			b->failed = !this->codec->decompress(b->in, b->in_len, b->out, b->out_len);
 		}
+	}
 
-		if (threaded) {
-			SetAsyncSaveFinish(asfp);
+	/**
+	 * Handle the queued blocks until told to exit.
+	 * @param arg The worker pool.
+	 */
+	static void WorkerThread(void *arg)
+	{
+		SaveLoadBlockWorkers *workers = (SaveLoadBlockWorkers *)arg;
+		for (;;) {
+			workers->queue_mutex->BeginCritical();
+			while (workers->queue.empty() && !workers->exit) workers->queue_mutex->WaitForSignal();
+			if (workers->exit) {
+				workers->queue_mutex->EndCritical();
+				return;
+			}
+			SaveLoadBlock *b = workers->queue.front();
+			workers->queue.pop_front();
+			workers->queue_mutex->EndCritical();
+
+			workers->Process(b);
+
+			workers->done_mutex->BeginCritical();
+			b->done = true;
+			workers->done_mutex->SendSignal();
+			workers->done_mutex->EndCritical();
+		}
+	}
+
+public:
+	/**
+	 * Start the workers.
+	 * @param codec    The compression to use.
+	 * @param compress Whether to compress instead of decompress.
+	 * @param level    The level of compression.
+	 */
+	SaveLoadBlockWorkers(const BlockCodec *codec, bool compress, byte level) : codec(codec), compress(compress), level(level), exit(false)
+	{
+		this->queue_mutex = ThreadMutex::New();
+		this->done_mutex = ThreadMutex::New();
+
+		uint count = _sl.no_threads ? 0 : Clamp(GetCPUCoreCount(), 1, 8);
+		for (uint i = 0; i < count; i++) {
+			ThreadObject *thread;
+			if (!ThreadObject::New(&SaveLoadBlockWorkers::WorkerThread, this, &thread)) break;
+			*this->threads.Append() = thread;
+		}
+		DEBUG(sl, 2, "Using %u threads to %s blocks", this->threads.Length(), compress ? "compress" : "decompress");
+	}
+
+	/** Stop the workers; blocks that are still queued are not handled anymore. */
+	~SaveLoadBlockWorkers()
+	{
+		this->queue_mutex->BeginCritical();
+		this->exit = true;
+		for (uint i = 0; i < this->threads.Length(); i++) this->queue_mutex->SendSignal();
+		this->queue_mutex->EndCritical();
+
+		for (uint i = 0; i < this->threads.Length(); i++) {
+			this->threads[i]->Join();
+			delete this->threads[i];
+		}
+
+		delete this->queue_mutex;
+		delete this->done_mutex;
+	}
+
+	/**
+	 * Get the number of blocks that should be in flight to keep all workers busy.
+	 * @return The number of blocks.
+	 */
+	uint GetQueueLength() const
+	{
+		return max(1U, this->threads.Length() * 2);
+	}
+
+	/**
+	 * Let the block be compressed or decompressed.
+	 * @param b The block.
+	 */
+	void Submit(SaveLoadBlock *b)
+	{
+		if (this->threads.Length() == 0) {
+			this->Process(b);
+			b->done = true;
+			return;
+		}
+
+		this->queue_mutex->BeginCritical();
+		this->queue.push_back(b);
+		this->queue_mutex->SendSignal();
+		this->queue_mutex->EndCritical();
+	}
+
+	/**
+	 * Wait till a submitted block has been compressed or decompressed.
+	 * @param b The block.
+	 */
+	void WaitFor(SaveLoadBlock *b)
+	{
+		this->done_mutex->BeginCritical();
+		while (!b->done) this->done_mutex->WaitForSignal();
+		this->done_mutex->EndCritical();
+	}
+};
+
+/** Filter decompressing the blocks of the block formats in parallel. */
+struct BlockLoadFilter : LoadFilter {
+	SaveLoadBlockWorkers *workers;     ///< The workers decompressing the blocks.
+	SmallDeque<SaveLoadBlock *> blocks; ///< The blocks being read, in order.
+	size_t pos;                        ///< Position in the first block.
+	bool end;                          ///< Whether the last block has been read.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The next filter in this chain.
+	 */
+	BlockLoadFilter(LoadFilter *chain) : LoadFilter(chain), workers(NULL), pos(0), end(false)
+	{
+		uint32 tag;
+		if (this->chain->Read((byte *)&tag, sizeof(tag)) != sizeof(tag)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+
+		for (const BlockCodec * const *codec = _block_codecs; *codec != NULL; codec++) {
+			if ((*codec)->tag == tag) {
+				this->workers = new SaveLoadBlockWorkers(*codec, false, 0);
+				return;
+			}
+		}
+		SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "decompressor for the blocks is not available");
+	}
+
+	/** Clean everything up. */
+	~BlockLoadFilter()
+	{
+		delete this->workers;
+		while (!this->blocks.empty()) {
+			delete this->blocks.front();
+			this->blocks.pop_front();
+		}
+	}
+
+	/** Read blocks from the file and let them be decompressed, until enough are in flight. */
+	void ReadAhead()
+	{
+		while (!this->end && this->blocks.size() < this->workers->GetQueueLength()) {
+			uint32 hdr[2];
+			if (this->chain->Read((byte *)hdr, sizeof(hdr)) != sizeof(hdr)) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+			size_t out_len = TO_BE32(hdr[0]);
+			size_t in_len = TO_BE32(hdr[1]);
+			if (out_len == 0) {
+				this->end = true;
+				break;
+			}
+			if (out_len > BLOCK_SIZE || in_len == 0 || in_len > BLOCK_SIZE * 2) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "invalid block size");
+
+			SaveLoadBlock *b = new SaveLoadBlock(in_len, out_len);
+			this->blocks.push_back(b);
+			for (size_t read = 0; read < in_len;) {
+				size_t len = this->chain->Read(b->in + read, in_len - read);
+				if (len == 0) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+				read += len;
+			}
+			this->workers->Submit(b);
+		}
+	}
+
+	/* virtual */ size_t Read(byte *buf, size_t size)
+	{
+		size_t read = 0;
+		while (read < size) {
+			this->ReadAhead();
+			if (this->blocks.empty()) break;
+
+			SaveLoadBlock *b = this->blocks.front();
+			this->workers->WaitFor(b);
+			if (b->failed) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "decompressing a block failed");
+
+			size_t len = min(size - read, b->out_len - this->pos);
+			memcpy(buf + read, b->out + this->pos, len);
+			read += len;
+			this->pos += len;
+
+			if (this->pos == b->out_len) {
+				delete b;
+				this->blocks.pop_front();
+				this->pos = 0;
+			}
+		}
+		return read;
+	}
+};
+
+/**
+ * Filter reading a range of the uncompressed savegame of the block formats,
+ * by decompressing only the blocks that range is in. The blocks are found
+ * through the chunk index.
+ */
+struct ChunkIndexLoadFilter : LoadFilter {
+	FILE *file;                      ///< The savegame; owned by the FileReader in the chain.
+	long begin;                      ///< Offset of the codec tag in the file.
+	const BlockCodec *codec;         ///< The compression of the blocks.
+	SmallVector<uint64, 64> offsets; ///< Offsets of the blocks, relative to #begin.
+	size_t pos;                      ///< Current position in the uncompressed savegame.
+	size_t end;                      ///< End of the range to read.
+	SaveLoadBlock *block;            ///< The decompressed block #pos was last in.
+	uint block_index;                ///< The index of #block.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain The file reader of the savegame.
+	 * @param begin Offset of the codec tag in the file.
+	 * @param codec The compression of the blocks.
+	 */
+	ChunkIndexLoadFilter(FileReader *chain, long begin, const BlockCodec *codec) : LoadFilter(chain), file(chain->file), begin(begin), codec(codec), pos(0), end(0), block(NULL), block_index(0)
+	{
+	}
+
+	/** Clean up what we allocated. */
+	~ChunkIndexLoadFilter()
+	{
+		delete this->block;
+	}
+
+	/**
+	 * Let the next reads return the given range of the uncompressed savegame.
+	 * @param begin Start of the range.
+	 * @param end   End of the range.
+	 */
+	void Seek(size_t begin, size_t end)
+	{
+		this->pos = begin;
+		this->end = end;
+	}
+
+	/**
+	 * Decompress a block.
+	 * @param index The index of the block.
+	 */
+	void LoadBlock(uint index)
+	{
+		delete this->block;
+		this->block = NULL;
+
+		uint32 hdr[2];
+		if (index >= this->offsets.Length() || fseek(this->file, this->begin + this->offsets[index], SEEK_SET) != 0 ||
+				fread(hdr, sizeof(hdr), 1, this->file) != 1) {
+			SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+		}
+		size_t out_len = TO_BE32(hdr[0]);
+		size_t in_len = TO_BE32(hdr[1]);
+		if (out_len == 0 || out_len > BLOCK_SIZE || in_len == 0 || in_len > BLOCK_SIZE * 2) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "invalid block size");
+
+		this->block = new SaveLoadBlock(in_len, out_len);
+		this->block_index = index;
+		if (fread(this->block->in, in_len, 1, this->file) != 1) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE);
+		if (!this->codec->decompress(this->block->in, in_len, this->block->out, out_len)) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "decompressing a block failed");
+	}
+
+	/* virtual */ size_t Read(byte *buf, size_t size)
+	{
+		size_t read = 0;
+		while (read < size && this->pos < this->end) {
+			uint index = (uint)(this->pos / BLOCK_SIZE);
+			if (this->block == NULL || this->block_index != index) this->LoadBlock(index);
+
+			size_t offset = this->pos - index * BLOCK_SIZE;
+			if (offset >= this->block->out_len) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "chunk index does not match the blocks");
+
+			size_t len = min(min(size - read, this->end - this->pos), this->block->out_len - offset);
+			memcpy(buf + read, this->block->out + offset, len);
+			read += len;
+			this->pos += len;
+		}
+		return read;
+	}
+};
+
+/** Filter compressing the savegame in blocks in parallel. */
+struct BlockSaveFilter : SaveFilter {
+	const BlockCodec *codec;            ///< The compression of the blocks.
+	SaveLoadBlockWorkers *workers;      ///< The workers compressing the blocks.
+	SmallDeque<SaveLoadBlock *> blocks; ///< The blocks being compressed, in order.
+	SaveLoadBlock *current;             ///< The block being filled.
+	SmallVector<uint64, 64> offsets;    ///< Offsets of the written blocks, for the chunk index.
+	size_t written;                     ///< Amount of data written to the next filter.
+
+	/**
+	 * Initialise this filter.
+	 * @param chain             The next filter in this chain.
+	 * @param compression_level The requested level of compression.
+	 * @param codec             The compression of the blocks.
+	 */
+	BlockSaveFilter(SaveFilter *chain, byte compression_level, const BlockCodec *codec) : SaveFilter(chain), codec(codec), current(NULL), written(0)
+	{
+		this->workers = new SaveLoadBlockWorkers(codec, true, compression_level);
+		uint32 tag = codec->tag;
+		this->WriteToChain((byte *)&tag, sizeof(tag));
+	}
+
+	/** Clean up what we allocated. */
+	~BlockSaveFilter()
+	{
+		delete this->workers;
+		delete this->current;
+		while (!this->blocks.empty()) {
+			delete this->blocks.front();
+			this->blocks.pop_front();
+		}
+	}
+
+	/**
+	 * Write data to the next filter, keeping track of the offset.
+	 * @param buf  The data to write.
+	 * @param size The amount of data to write.
+	 */
+	void WriteToChain(byte *buf, size_t size)
+	{
+		this->chain->Write(buf, size);
+		this->written += size;
+	}
+
+	/**
+	 * Write big endian uint32s to the next filter.
+	 * @param values The values to write.
+	 * @param count  The number of values.
+	 */
+	void WriteUint32s(const uint32 *values, uint count)
+	{
+		uint32 buf[64];
+		while (count > 0) {
+			uint len = min(count, (uint)lengthof(buf));
+			for (uint i = 0; i < len; i++) buf[i] = TO_BE32(values[i]);
+			this->WriteToChain((byte *)buf, len * sizeof(uint32));
+			values += len;
+			count -= len;
+		}
+	}
+
+	/**
+	 * Write big endian uint64s to the next filter.
+	 * @param values The values to write.
+	 * @param count  The number of values.
+	 */
+	void WriteUint64s(const uint64 *values, uint count)
+	{
+		for (uint i = 0; i < count; i++) {
+			uint32 buf[2] = { (uint32)(values[i] >> 32), (uint32)values[i] };
+			this->WriteUint32s(buf, lengthof(buf));
+		}
+	}
+
+	/** Write the chunk index of the savegame that has been written. */
+	void WriteChunkIndex()
+	{
+		/* Without the dumper we do not know the chunks; the chunk index is optional anyway.
+		 * For a delta the chunks are not those of the written data. */
+		if (_sl.dumper == NULL || _sl.delta_mode == SDM_DELTA) return;
+
+		uint64 index_offset = this->written;
+		uint32 tag = TO_BE32X('OTTI');
+		this->WriteToChain((byte *)&tag, sizeof(tag));
+
+		uint32 count = this->offsets.Length();
+		this->WriteUint32s(&count, 1);
+		this->WriteUint64s(this->offsets.Begin(), count);
+
+		const SmallVector<ChunkIndexEntry, 64> &chunks = _sl.dumper->chunks;
+		count = chunks.Length();
+		this->WriteUint32s(&count, 1);
+		for (const ChunkIndexEntry *entry = chunks.Begin(); entry != chunks.End(); entry++) {
+			this->WriteUint32s(&entry->id, 1);
+			this->WriteUint64s(&entry->offset, 1);
+		}
+
+		this->WriteUint64s(&index_offset, 1);
+		this->WriteToChain((byte *)&tag, sizeof(tag));
+	}
+
+	/**
+	 * Write compressed blocks to the file, until at most the given number is in flight.
+	 * @param in_flight The number of blocks that may still be compressing.
+	 */
+	void WriteBlocks(uint in_flight)
+	{
+		while (this->blocks.size() > in_flight) {
+			SaveLoadBlock *b = this->blocks.front();
+			this->workers->WaitFor(b);
+			if (b->failed) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "compressing a block failed");
+
+			*this->offsets.Append() = this->written;
+			uint32 hdr[2] = { TO_BE32((uint32)b->in_len), TO_BE32((uint32)b->out_len) };
+			this->WriteToChain((byte *)hdr, sizeof(hdr));
+			this->WriteToChain(b->out, b->out_len);
+
+			delete b;
+			this->blocks.pop_front();
+		}
+	}
+
+	/** Let the block being filled be compressed. */
+	void SubmitCurrent()
+	{
+		this->blocks.push_back(this->current);
+		this->workers->Submit(this->current);
+		this->current = NULL;
+		this->WriteBlocks(this->workers->GetQueueLength());
+	}
+
+	/* virtual */ void Write(byte *buf, size_t size)
+	{
+		while (size > 0) {
+			if (this->current == NULL) {
+				this->current = new SaveLoadBlock(BLOCK_SIZE, this->codec->bound(BLOCK_SIZE));
+				this->current->in_len = 0;
+			}
+
+			size_t len = min(size, BLOCK_SIZE - this->current->in_len);
+			memcpy(this->current->in + this->current->in_len, buf, len);
+			this->current->in_len += len;
+			buf += len;
+			size -= len;
+
+			if (this->current->in_len == BLOCK_SIZE) this->SubmitCurrent();
+		}
+	}
+
+	/* virtual */ void Finish()
+	{
+		if (this->current != NULL) this->SubmitCurrent();
+		this->WriteBlocks(0);
+
+		uint32 hdr[2] = { 0, 0 };
+		this->WriteToChain((byte *)hdr, sizeof(hdr));
+		this->WriteChunkIndex();
+		this->chain->Finish();
+	}
+};
+
+#if defined(WITH_ZLIB)
+/** Filter compressing the savegame in blocks in parallel with zlib. */
+struct ZlibBlockSaveFilter : BlockSaveFilter {
+	/**
+	 * Initialise this filter.
+	 * @param chain             The next filter in this chain.
+	 * @param compression_level The requested level of compression.
+	 */
+	ZlibBlockSaveFilter(SaveFilter *chain, byte compression_level) : BlockSaveFilter(chain, compression_level, &_zlib_block_codec)
+	{
+	}
+};
+#endif /* WITH_ZLIB */
+
+#if defined(WITH_LZMA)
+/** Filter compressing the savegame in blocks in parallel with LZMA. */
+struct LZMABlockSaveFilter : BlockSaveFilter {
+	/**
+	 * Initialise this filter.
+	 * @param chain             The next filter in this chain.
+	 * @param compression_level The requested level of compression.
+	 */
+	LZMABlockSaveFilter(SaveFilter *chain, byte compression_level) : BlockSaveFilter(chain, compression_level, &_lzma_block_codec)
+	{
+	}
+};
+#endif /* WITH_LZMA */
+
+/********************************************
+ ********** START OF THREADED LOAD CODE *****
+ ********************************************/
+
+/**
+ * Filter that reads the savegame ahead from the next filter on a separate
+ * thread, so decompressing overlaps with the parsing of the chunks. The read
+ * data is kept in a bounded ring of buffers. Errors on the loader thread are
+ * only recorded in the filter, and raised with SlError on the main thread
+ * once it has consumed the data read before the error.
+ */
+struct ThreadedLoadFilter : LoadFilter {
+	static const uint BUFFERS = 8; ///< Number of buffers in the ring.
+
+	/** A buffer with read ahead data. */
+	struct Buffer {
+		byte data[MEMORY_CHUNK_SIZE]; ///< The data.
+		size_t len;                   ///< Amount of valid data.
+	};
+
+	Buffer *buffers;      ///< The ring of buffers.
+	uint head;            ///< First filled buffer in the ring.
+	uint count;           ///< Number of filled buffers in the ring.
+	size_t pos;           ///< Position in the first filled buffer; only used by the main thread.
+	bool end;             ///< Whether the next filter has no more data.
+	bool failed;          ///< Whether reading from the next filter failed.
+	bool stop;            ///< Whether the loader thread has to stop.
+	StringID error_str;   ///< The error of the loader thread, when #failed.
+	char *error_msg;      ///< The extra message of that error, or \c NULL.
+	ThreadMutex *mutex;   ///< Guards #head, #count, #end, #failed and #stop.
+	ThreadObject *thread; ///< The loader thread, or \c NULL when reading on the main thread.
+
+	/**
+	 * Initialise this filter and start the loader thread.
+	 * @param chain The next filter in this chain.
+	 */
+	ThreadedLoadFilter(LoadFilter *chain) : LoadFilter(chain), buffers(NULL), head(0), count(0), pos(0), end(false), failed(false), stop(false), error_str(INVALID_STRING_ID), error_msg(NULL), mutex(NULL), thread(NULL)
+	{
+		this->buffers = MallocT<Buffer>(BUFFERS);
+		this->mutex = ThreadMutex::New();
+
+		/* The loader thread waits for the mutex, so it can only call SlError
+		 * once it is known to be the loader thread. */
+		this->mutex->BeginCritical();
+		if (!ThreadObject::New(&ThreadedLoadFilter::LoaderThread, this, &this->thread)) {
+			DEBUG(sl, 1, "Cannot create savegame loader thread, reverting to single-threaded mode...");
+			this->thread = NULL;
+		}
+		_sl.loader_thread = this->thread;
+		this->mutex->EndCritical();
+	}
+
+	/** Stop the loader thread and clean up. */
+	~ThreadedLoadFilter()
+	{
+		if (this->thread != NULL) {
+			this->mutex->BeginCritical();
+			this->stop = true;
+			this->mutex->SendSignal();
+			this->mutex->EndCritical();
+
+			this->thread->Join();
+			delete this->thread;
+			_sl.loader_thread = NULL;
+		}
+
+		delete this->mutex;
+		free(this->buffers);
+		free(this->error_msg);
+	}
+
+	/**
+	 * Fill the buffers of the ring, until the ring is full or the data ends.
+	 * @param arg The filter.
+	 */
+	static void LoaderThread(void *arg)
+	{
+		ThreadedLoadFilter *lf = (ThreadedLoadFilter *)arg;
+		for (;;) {
+			lf->mutex->BeginCritical();
+			while (lf->count == BUFFERS && !lf->stop) lf->mutex->WaitForSignal();
+			if (lf->stop) {
+				lf->mutex->EndCritical();
+				return;
+			}
+			Buffer *b = &lf->buffers[(lf->head + lf->count) % BUFFERS];
+			lf->mutex->EndCritical();
+
+			/* Only the loader thread touches the buffers past the filled ones. */
+			bool end = false;
+			bool failed = false;
+			SlLoaderError error;
+			b->len = 0;
+			try {
+				while (b->len < lengthof(b->data)) {
+					size_t len = lf->chain->Read(b->data + b->len, lengthof(b->data) - b->len);
+					if (len == 0) {
+						end = true;
+						break;
+					}
+					b->len += len;
+				}
+			} catch (SlLoaderError &e) {
+				failed = true;
+				error = e;
+			} catch (...) {
+				failed = true;
+				error.string = STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME;
+				error.extra_msg = strdup("reading ahead failed");
+			}
+
+			lf->mutex->BeginCritical();
+			if (!failed && b->len != 0) lf->count++;
+			if (failed) {
+				lf->error_str = error.string;
+				lf->error_msg = error.extra_msg;
+			}
+			lf->end = end;
+			lf->failed = failed;
+			lf->mutex->SendSignal();
+			lf->mutex->EndCritical();
+
+			if (end || failed) return;
+		}
+	}
+
+	/* virtual */ size_t Read(byte *buf, size_t size)
+	{
+		if (this->thread == NULL) return this->chain->Read(buf, size);
+
+		size_t read = 0;
+		while (read < size) {
+			this->mutex->BeginCritical();
+			while (this->count == 0 && !this->end && !this->failed) this->mutex->WaitForSignal();
+			if (this->count == 0) {
+				bool failed = this->failed;
+				this->mutex->EndCritical();
+				/* The loader thread has stopped after failing, so its error can be read safely. */
+				if (failed) SlError(this->error_str, this->error_msg);
+				break;
+			}
+			Buffer *b = &this->buffers[this->head];
+			this->mutex->EndCritical();
+
+			size_t len = min(size - read, b->len - this->pos);
+			memcpy(buf + read, b->data + this->pos, len);
+			read += len;
+			this->pos += len;
+
+			if (this->pos == b->len) {
+				this->pos = 0;
+				this->mutex->BeginCritical();
+				this->head = (this->head + 1) % BUFFERS;
+				this->count--;
+				this->mutex->SendSignal();
+				this->mutex->EndCritical();
+			}
+		}
+		return read;
+	}
+
+	/* virtual */ void Reset()
+	{
+		/* The loader thread only starts once the format is known, after which nothing is reread. */
+		NOT_REACHED();
+	}
+};
+
+/********************************************
+ ********** START OF DELTA CODE *************
+ ********************************************/
+
+/*
+ * Delta autosaves only store what changed since the last full autosave,
+ * their base. When the base is written, a signature is written next to it
+ * ("<base>.sig"); it holds the hash of the whole uncompressed savegame and,
+ * for every chunk, the hashes of its regions of DELTA_REGION_SIZE bytes.
+ * A delta autosave compares the new savegame against that signature, and
+ * stores the regions that did not change as copies from the base and the
+ * rest as data. Loading a delta rebuilds the savegame from the base.
+ *
+ * After the savegame header with tag 'OTTP' follows the tag of the format
+ * the remainder is compressed with. The remainder is the name of the base,
+ * the size and hash of the base, the size of the rebuilt savegame, and then
+ * the operations, each starting with one of the DeltaOperation bytes.
+ */
+
+static const size_t DELTA_REGION_SIZE = 4096; ///< Size of the regions of a chunk that are compared for a delta.
+static const uint64 DELTA_HASH_BASIS = 0xCBF29CE484222325ULL; ///< Start value of #DeltaHash.
+
+/** Operations to rebuild a savegame from its base. */
+enum DeltaOperation {
+	DO_END,  ///< End of the delta.
+	DO_COPY, ///< Copy from the base; followed by the offset in the base and the length.
+	DO_DATA, ///< New data; followed by the length and the data.
+};
+
+/**
+ * Hash data for the comparison with the base of a delta autosave (64 bits FNV-1a).
+ * @param buf  The data.
+ * @param len  Length of the data.
+ * @param hash Hash of the data before this data.
+ * @return The hash.
+ */
+static uint64 DeltaHash(const byte *buf, size_t len, uint64 hash = DELTA_HASH_BASIS)
+{
+	for (const byte *end = buf + len; buf != end; buf++) {
+		hash ^= *buf;
+		hash *= 0x100000001B3ULL;
+	}
+	return hash;
+}
+
+/** The signature of the base of delta autosaves. */
+struct DeltaSignature {
+	uint32 size;                             ///< Size of the uncompressed savegame.
+	uint64 hash;                             ///< Hash of the uncompressed savegame.
+	SmallVector<ChunkIndexEntry, 64> chunks; ///< The chunks in the savegame, ending with the terminator.
+	SmallVector<uint64, 256> regions;        ///< The hashes of the regions of all chunks, in order.
+
+	/**
+	 * Get the length of a chunk.
+	 * @param i The index of the chunk.
+	 * @return The length.
+	 */
+	inline uint32 GetLength(uint i) const
+	{
+		return (uint32)((i + 1 < this->chunks.Length() ? this->chunks[i + 1].offset : this->size) - this->chunks[i].offset);
+	}
+
+	/**
+	 * Get the number of regions of a chunk.
+	 * @param len The length of the chunk.
+	 * @return The number of regions.
+	 */
+	static inline uint GetRegionCount(uint32 len)
+	{
+		return (len + DELTA_REGION_SIZE - 1) / DELTA_REGION_SIZE;
+	}
+
+	bool Load(const char *base);
+	bool Save(const char *base, const MemoryDumper *dumper);
+};
+
+/** Filter rebuilding a delta savegame from its base. */
+struct DeltaLoadFilter : LoadFilter {
+	byte *buf;  ///< The rebuilt savegame.
+	size_t pos; ///< Position in #buf.
+	size_t len; ///< Size of #buf.
+
+	DeltaLoadFilter(LoadFilter *chain);
+	void Rebuild();
+
+	/** Clean up what we allocated. */
+	~DeltaLoadFilter()
+	{
+		free(this->buf);
+	}
+
+	/**
+	 * Read exactly the requested amount of data from the delta.
+	 * @param buf  Buffer to read into.
+	 * @param size The amount of data to read.
+	 */
+	void ReadDelta(byte *buf, size_t size)
+	{
+		while (size > 0) {
+			size_t len = this->chain->Read(buf, size);
+			if (len == 0) SlErrorCorrupt("Unexpected end of the delta");
+			buf += len;
+			size -= len;
+		}
+	}
+
+	/**
+	 * Read a big endian uint32 from the delta.
+	 * @return The read value.
+	 */
+	uint32 ReadDeltaUint32()
+	{
+		uint32 value;
+		this->ReadDelta((byte *)&value, sizeof(value));
+		return TO_BE32(value);
+	}
+
+	/* virtual */ size_t Read(byte *buf, size_t size)
+	{
+		size_t len = min(size, this->len - this->pos);
+		memcpy(buf, this->buf + this->pos, len);
+		this->pos += len;
+		return len;
+	}
+};
+
+/*******************************************
+ ************* END OF CODE *****************
+ *******************************************/
+
+/** The format for a reader/writer type of a savegame */
+struct SaveLoadFormat {
+	const char *name;                     ///< name of the compressor/decompressor (debug-only)
+	uint32 tag;                           ///< the 4-letter tag by which it is identified in the savegame
+
+	LoadFilter *(*init_load)(LoadFilter *chain);                    ///< Constructor for the load filter.
+	SaveFilter *(*init_write)(SaveFilter *chain, byte compression); ///< Constructor for the save filter.
+
+	byte min_compression;                 ///< the minimum compression level of this format
+	byte default_compression;             ///< the default compression level of this format
+	byte max_compression;                 ///< the maximum compression level of this format
+};
+
+/** The different saveload formats known/understood by OpenTTD. */
+static const SaveLoadFormat _saveload_formats[] = {
+#if defined(WITH_LZO)
+	/* Roughly 75% larger than zlib level 6 at only ~7% of the CPU usage. */
+	{"lzo",    TO_BE32X('OTTD'), CreateLoadFilter<LZOLoadFilter>,    CreateSaveFilter<LZOSaveFilter>,    0, 0, 0},
+#else
+	{"lzo",    TO_BE32X('OTTD'), NULL,                               NULL,                               0, 0, 0},
+#endif
+	/* Roughly 5 times larger at only 1% of the CPU usage over zlib level 6. */
+	{"none",   TO_BE32X('OTTN'), CreateLoadFilter<NoCompLoadFilter>, CreateSaveFilter<NoCompSaveFilter>, 0, 0, 0},
+	/* The same compressions, but in independent blocks of BLOCK_SIZE bytes that are (de)compressed by all cores at
+	 * once. The blocks compress slightly worse. Both share the tag, the compression of the blocks follows the header.
+	 * They are listed before the plain compressions so those remain the default. */
+#if defined(WITH_ZLIB)
+	{"zlib_mt", TO_BE32X('OTTM'), CreateLoadFilter<BlockLoadFilter>, CreateSaveFilter<ZlibBlockSaveFilter>, 0, 6, 9},
+#else
+	{"zlib_mt", TO_BE32X('OTTM'), CreateLoadFilter<BlockLoadFilter>, NULL,                                  0, 0, 0},
+#endif
+#if defined(WITH_LZMA)
+	{"lzma_mt", TO_BE32X('OTTM'), CreateLoadFilter<BlockLoadFilter>, CreateSaveFilter<LZMABlockSaveFilter>, 0, 2, 9},
+#else
+	{"lzma_mt", TO_BE32X('OTTM'), CreateLoadFilter<BlockLoadFilter>, NULL,                                  0, 0, 0},
+#endif
+#if defined(WITH_ZLIB)
+	/* After level 6 the speed reduction is significant (1.5x to 2.5x slower per level), but the reduction in filesize is
+	 * fairly insignificant (~1% for each step). Lower levels become ~5-10% bigger by each level than level 6 while level
+	 * 1 is "only" 3 times as fast. Level 0 results in uncompressed savegames at about 8 times the cost of "none". */
+	{"zlib",   TO_BE32X('OTTZ'), CreateLoadFilter<ZlibLoadFilter>,   CreateSaveFilter<ZlibSaveFilter>,   0, 6, 9},
+#else
+	{"zlib",   TO_BE32X('OTTZ'), NULL,                               NULL,                               0, 0, 0},
+#endif
+#if defined(WITH_LZMA)
+	/* Level 2 compression is speed wise as fast as zlib level 6 compression (old default), but results in ~10% smaller saves.
+	 * Higher compression levels are possible, and might improve savegame size by up to 25%, but are also up to 10 times slower.
+	 * The next significant reduction in file size is at level 4, but that is already 4 times slower. Level 3 is primarily 50%
+	 * slower while not improving the filesize, while level 0 and 1 are faster, but don't reduce savegame size much.
+	 * It's OTTX and not e.g. OTTL because liblzma is part of xz-utils and .tar.xz is preferred over .tar.lzma. */
+	{"lzma",   TO_BE32X('OTTX'), CreateLoadFilter<LZMALoadFilter>,   CreateSaveFilter<LZMASaveFilter>,   0, 2, 9},
+#else
+	{"lzma",   TO_BE32X('OTTX'), NULL,                               NULL,                               0, 0, 0},
+#endif
+	/* Delta autosaves; only autosaving writes them, using one of the formats above for their contents. */
+	{"delta",  TO_BE32X('OTTP'), CreateLoadFilter<DeltaLoadFilter>,  NULL,                               0, 0, 0},
+};
+
+/**
+ * Return the savegameformat of the game. Whether it was created with ZLIB compression
+ * uncompressed, or another type
+ * @param s Name of the savegame format. If NULL it picks the first available one
+ * @param compression_level Output for telling what compression level we want.
+ * @return Pointer to SaveLoadFormat struct giving all characteristics of this type of savegame
+ */
+static const SaveLoadFormat *GetSavegameFormat(char *s, byte *compression_level)
+{
+	const SaveLoadFormat *def = lastof(_saveload_formats);
+
+	/* find default savegame format, the highest one with which files can be written */
+	while (!def->init_write) def--;
+
+	if (!StrEmpty(s)) {
+		/* Get the ":..." of the compression level out of the way */
+		char *complevel = strrchr(s, ':');
+		if (complevel != NULL) *complevel = '\0';
+
+		for (const SaveLoadFormat *slf = &_saveload_formats[0]; slf != endof(_saveload_formats); slf++) {
+			if (slf->init_write != NULL && strcmp(s, slf->name) == 0) {
+				*compression_level = slf->default_compression;
+				if (complevel != NULL) {
+					/* There is a compression level in the string.
+					 * First restore the : we removed to do proper name matching,
+					 * then move the the begin of the actual version. */
+					*complevel = ':';
+					complevel++;
+
+					/* Get the version and determine whether all went fine. */
+					char *end;
+					long level = strtol(complevel, &end, 10);
+					if (end == complevel || level != Clamp(level, slf->min_compression, slf->max_compression)) {
+						SetDParamStr(0, complevel);
+						ShowErrorMessage(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_SAVEGAME_COMPRESSION_LEVEL, WL_CRITICAL);
+					} else {
+						*compression_level = level;
+					}
+				}
+				return slf;
+			}
+		}
+
+		SetDParamStr(0, s);
+		SetDParamStr(1, def->name);
+		ShowErrorMessage(STR_CONFIG_ERROR, STR_CONFIG_ERROR_INVALID_SAVEGAME_COMPRESSION_ALGORITHM, WL_CRITICAL);
+
+		/* Restore the string by adding the : back */
+		if (complevel != NULL) *complevel = ':';
+	}
+	*compression_level = def->default_compression;
+	return def;
+}
+
+/**
+ * Find the format to load a savegame or the contents of a delta with.
+ * @param tag The tag of the format.
+ * @return The format, or \c NULL when it cannot be loaded. Delta savegames are not valid here.
+ */
+static const SaveLoadFormat *GetDeltaLoadFormat(uint32 tag)
+{
+	for (const SaveLoadFormat *fmt = _saveload_formats; fmt != endof(_saveload_formats); fmt++) {
+		if (fmt->tag == tag && fmt->tag != TO_BE32X('OTTP') && fmt->init_load != NULL) return fmt;
+	}
+	return NULL;
+}
+
+/**
+ * Read a big endian uint32 from a file.
+ * @param fh    The file to read from.
+ * @param value Output for the read value.
+ * @return Whether reading succeeded.
+ */
+static bool ReadBigEndianUint32(FILE *fh, uint32 *value)
+{
+	if (fread(value, sizeof(*value), 1, fh) != 1) return false;
+	*value = TO_BE32(*value);
+	return true;
+}
+
+/**
+ * Read a big endian uint64 from a file.
+ * @param fh    The file to read from.
+ * @param value Output for the read value.
+ * @return Whether reading succeeded.
+ */
+static bool ReadBigEndianUint64(FILE *fh, uint64 *value)
+{
+	uint32 hi, lo;
+	if (!ReadBigEndianUint32(fh, &hi) || !ReadBigEndianUint32(fh, &lo)) return false;
+	*value = (uint64)hi << 32 | lo;
+	return true;
+}
+
+/**
+ * Write a big endian uint32 to a file.
+ * @param fh    The file to write to.
+ * @param value The value to write.
+ * @return Whether writing succeeded.
+ */
+static bool WriteBigEndianUint32(FILE *fh, uint32 value)
+{
+	value = TO_BE32(value);
+	return fwrite(&value, sizeof(value), 1, fh) == 1;
+}
+
+/**
+ * Load the signature of the base of delta autosaves.
+ * @param base The name of the base in the autosave directory.
+ * @return Whether the signature could be loaded and is for this savegame version.
+ */
+bool DeltaSignature::Load(const char *base)
+{
+	char name[MAX_PATH];
+	snprintf(name, lengthof(name), "%s.sig", base);
+	FILE *fh = FioFOpenFile(name, "rb", AUTOSAVE_DIR);
+	if (fh == NULL) return false;
+
+	uint32 tag, version, hash[2], count, offset;
+	bool ok = fread(&tag, sizeof(tag), 1, fh) == 1 && tag == TO_BE32X('OTTS') &&
+			ReadBigEndianUint32(fh, &version) && version == SAVEGAME_VERSION &&
+			ReadBigEndianUint32(fh, &this->size) && ReadBigEndianUint32(fh, &hash[0]) && ReadBigEndianUint32(fh, &hash[1]) &&
+			ReadBigEndianUint32(fh, &count) && count != 0 && count <= this->size / sizeof(uint32);
+	this->hash = (uint64)hash[0] << 32 | hash[1];
+
+	this->chunks.Clear();
+	for (uint i = 0; ok && i < count; i++) {
+		ChunkIndexEntry *entry = this->chunks.Append();
+		ok = ReadBigEndianUint32(fh, &entry->id) && ReadBigEndianUint32(fh, &offset);
+		entry->offset = offset;
+		ok = ok && entry->offset <= this->size && (i == 0 ? entry->offset == 0 : entry->offset >= entry[-1].offset);
+	}
+
+	this->regions.Clear();
+	for (uint i = 0; ok && i < count; i++) {
+		for (uint r = GetRegionCount(this->GetLength(i)); ok && r > 0; r--) {
+			ok = ReadBigEndianUint32(fh, &hash[0]) && ReadBigEndianUint32(fh, &hash[1]);
+			*this->regions.Append() = (uint64)hash[0] << 32 | hash[1];
+		}
+	}
+
+	fclose(fh);
+	return ok;
+}
+
+/**
+ * Make and save the signature of the base of delta autosaves.
+ * @param base   The name of the base in the autosave directory.
+ * @param dumper The savegame that has been written to the base.
+ * @return Whether the signature could be saved.
+ */
+bool DeltaSignature::Save(const char *base, const MemoryDumper *dumper)
+{
+	this->size = (uint32)dumper->GetSize();
+	this->hash = DELTA_HASH_BASIS;
+	this->chunks = dumper->chunks;
+	this->regions.Clear();
+
+	byte buf[DELTA_REGION_SIZE];
+	for (uint i = 0; i < this->chunks.Length(); i++) {
+		uint32 len = this->GetLength(i);
+		for (uint32 done = 0; done < len; done += DELTA_REGION_SIZE) {
+			uint32 region = min<uint32>(DELTA_REGION_SIZE, len - done);
+			dumper->CopyTo(this->chunks[i].offset + done, buf, region);
+			*this->regions.Append() = DeltaHash(buf, region);
+			this->hash = DeltaHash(buf, region, this->hash);
+		}
+	}
+
+	char name[MAX_PATH];
+	snprintf(name, lengthof(name), "%s.sig", base);
+	FILE *fh = FioFOpenFile(name, "wb", AUTOSAVE_DIR);
+	if (fh == NULL) return false;
+
+	uint32 tag = TO_BE32X('OTTS');
+	bool ok = fwrite(&tag, sizeof(tag), 1, fh) == 1 && WriteBigEndianUint32(fh, SAVEGAME_VERSION) &&
+			WriteBigEndianUint32(fh, this->size) && WriteBigEndianUint32(fh, (uint32)(this->hash >> 32)) && WriteBigEndianUint32(fh, (uint32)this->hash) &&
+			WriteBigEndianUint32(fh, this->chunks.Length());
+	for (const ChunkIndexEntry *entry = this->chunks.Begin(); ok && entry != this->chunks.End(); entry++) {
+		ok = WriteBigEndianUint32(fh, entry->id) && WriteBigEndianUint32(fh, (uint32)entry->offset);
+	}
+	for (const uint64 *hash = this->regions.Begin(); ok && hash != this->regions.End(); hash++) {
+		ok = WriteBigEndianUint32(fh, (uint32)(*hash >> 32)) && WriteBigEndianUint32(fh, (uint32)*hash);
+	}
+
+	ok = fclose(fh) == 0 && ok;
+	return ok;
+}
+
+/**
+ * Load the uncompressed base savegame of a delta.
+ * @param name The name of the base.
+ * @param size The size of the uncompressed base, according to the delta.
+ * @param hash The hash of the uncompressed base, according to the delta.
+ * @return The uncompressed base; the caller has to free it.
+ */
+static byte *LoadDeltaBase(const char *name, uint32 size, uint64 hash)
+{
+	FILE *fh = FioFOpenFile(name, "rb", AUTOSAVE_DIR);
+	if (fh == NULL) fh = FioFOpenFile(name, "rb", SAVE_DIR);
+	if (fh == NULL) SlError(STR_GAME_SAVELOAD_ERROR_FILE_NOT_READABLE, "base savegame of the delta autosave not found");
+
+	LoadFilter *reader = new FileReader(fh);
+	uint32 hdr[2];
+	const SaveLoadFormat *fmt = NULL;
+	if (reader->Read((byte *)hdr, sizeof(hdr)) == sizeof(hdr) && (TO_BE32(hdr[1]) >> 16) == _sl_version) fmt = GetDeltaLoadFormat(hdr[0]);
+	if (fmt == NULL) {
+		delete reader;
+		SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "base savegame of the delta autosave has changed");
+	}
+
+	reader = fmt->init_load(reader);
+	byte *buf = MallocT<byte>(size + 1);
+	size_t read = 0;
+	for (size_t len = 1; len != 0 && read <= size; read += len) {
+		len = reader->Read(buf + read, size + 1 - read);
+	}
+	delete reader;
+
+	if (read != size || DeltaHash(buf, size) != hash) {
+		free(buf);
+		SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_SAVEGAME, "base savegame of the delta autosave has changed");
+	}
+	return buf;
+}
+
+/**
+ * Initialise this filter and rebuild the savegame from its base.
+ * @param chain The next filter in this chain.
+ */
+DeltaLoadFilter::DeltaLoadFilter(LoadFilter *chain) : LoadFilter(chain), buf(NULL), pos(0), len(0)
+{
+	try {
+		this->Rebuild();
+	} catch (...) {
+		/* The caller still owns and deletes the chain it passed, but the
+		 * destructor of LoadFilter would delete it as well. So only delete
+		 * the decompression that has been put in between. */
+		if (this->chain != chain) {
+			this->chain->chain = NULL;
+			delete this->chain;
+		}
+		this->chain = NULL;
+		free(this->buf);
+		throw;
+	}
+}
+
+/** Read the delta and rebuild the savegame from the delta and its base. */
+void DeltaLoadFilter::Rebuild()
+{
+	uint32 tag;
+	this->ReadDelta((byte *)&tag, sizeof(tag));
+	const SaveLoadFormat *fmt = GetDeltaLoadFormat(tag);
+	if (fmt == NULL) SlError(STR_GAME_SAVELOAD_ERROR_BROKEN_INTERNAL_ERROR, "loader for the contents of the delta is not available");
+	this->chain = fmt->init_load(this->chain);
+
+	char name[MAX_PATH];
+	uint32 name_len = this->ReadDeltaUint32();
+	if (name_len >= lengthof(name)) SlErrorCorrupt("Invalid name of the base of the delta");
+	this->ReadDelta((byte *)name, name_len);
+	name[name_len] = '\0';
+	str_validate(name, lastof(name));
+
+	uint32 base_size = this->ReadDeltaUint32();
+	uint64 base_hash = (uint64)this->ReadDeltaUint32() << 32;
+	base_hash |= this->ReadDeltaUint32();
+	this->len = this->ReadDeltaUint32();
+
+	AutoFreePtr<byte> base(LoadDeltaBase(name, base_size, base_hash));
+	this->buf = MallocT<byte>(this->len);
+
+	size_t pos = 0;
+	for (;;) {
+		byte op;
+		this->ReadDelta(&op, sizeof(op));
+		if (op == DO_END) break;
+
+		uint32 offset = (op == DO_COPY) ? this->ReadDeltaUint32() : 0;
+		uint32 length = this->ReadDeltaUint32();
+		if (length > this->len - pos) SlErrorCorrupt("Delta is larger than its savegame");
+
+		switch (op) {
+			case DO_COPY:
+				if (offset > base_size || length > base_size - offset) SlErrorCorrupt("Delta copies from outside of its base");
+				memcpy(this->buf + pos, base + offset, length);
+				break;
+
+			case DO_DATA:
+				this->ReadDelta(this->buf + pos, length);
+				break;
+
+			default:
+				SlErrorCorrupt("Invalid delta operation");
+		}
+		pos += length;
+	}
+
+	if (pos != this->len) SlErrorCorrupt("Delta does not cover its savegame");
+}
+
+/** Writer of the operations of a delta, merging consecutive operations of the same kind. */
+struct DeltaWriter {
+	SaveFilter *writer;         ///< The filter to write the delta to.
+	const MemoryDumper *dumper; ///< The savegame the delta is made for.
+	DeltaOperation op;          ///< The pending operation, or #DO_END when there is none.
+	uint32 offset;              ///< Offset of the pending operation, in the base for copies and in the savegame for data.
+	uint32 length;              ///< Length of the pending operation.
+
+	/**
+	 * Create the writer.
+	 * @param writer The filter to write the delta to.
+	 * @param dumper The savegame the delta is made for.
+	 */
+	DeltaWriter(SaveFilter *writer, const MemoryDumper *dumper) : writer(writer), dumper(dumper), op(DO_END), offset(0), length(0)
+	{
+	}
+
+	/**
+	 * Write a big endian uint32.
+	 * @param value The value to write.
+	 */
+	void WriteUint32(uint32 value)
+	{
+		value = TO_BE32(value);
+		this->writer->Write((byte *)&value, sizeof(value));
+	}
+
+	/** Write the pending operation. */
+	void Flush()
+	{
+		if (this->op == DO_END) return;
+
+		byte op = this->op;
+		this->writer->Write(&op, sizeof(op));
+		if (this->op == DO_COPY) this->WriteUint32(this->offset);
+		this->WriteUint32(this->length);
+
+		if (this->op == DO_DATA) {
+			byte buf[DELTA_REGION_SIZE];
+			for (uint32 done = 0; done < this->length;) {
+				uint32 len = min<uint32>(sizeof(buf), this->length - done);
+				this->dumper->CopyTo(this->offset + done, buf, len);
+				this->writer->Write(buf, len);
+				done += len;
+			}
+		}
+		this->op = DO_END;
+	}
+
+	/**
+	 * Add an operation to the delta.
+	 * @param op     The operation, either #DO_COPY or #DO_DATA.
+	 * @param offset Offset in the base for copies, and in the savegame for data.
+	 * @param length Length of the copy or data.
+	 */
+	void Add(DeltaOperation op, uint32 offset, uint32 length)
+	{
+		if (this->op == op && this->offset + this->length == offset) {
+			this->length += length;
+			return;
+		}
+		this->Flush();
+		this->op = op;
+		this->offset = offset;
+		this->length = length;
+	}
+
+	/** Write the pending operation and end the delta. */
+	void Finish()
+	{
+		this->Flush();
+		byte op = DO_END;
+		this->writer->Write(&op, sizeof(op));
+	}
+};
+
+/**
+ * Write the savegame in memory as delta against the base of delta autosaves.
+ * @param fmt         The format to compress the delta with.
+ * @param compression The level of compression.
+ * @return Whether the delta has been written; when not, nothing has been written yet.
+ */
+static bool SaveDeltaToDisk(const SaveLoadFormat *fmt, byte compression)
+{
+	DeltaSignature base;
+	if (!base.Load(_sl.delta_base)) {
+		DEBUG(sl, 1, "Cannot read the signature of '%s', writing a full autosave instead", _sl.delta_base);
+		_sl.delta_mode = SDM_NONE;
+		return false;
+	}
+
+	uint32 hdr[3] = { TO_BE32X('OTTP'), TO_BE32(SAVEGAME_VERSION << 16), fmt->tag };
+	_sl.sf->Write((byte *)hdr, sizeof(hdr));
+	_sl.sf = fmt->init_write(_sl.sf, compression);
+
+	const MemoryDumper *dumper = _sl.dumper;
+	uint32 size = (uint32)dumper->GetSize();
+	DeltaWriter delta(_sl.sf, dumper);
+	delta.WriteUint32((uint32)strlen(_sl.delta_base));
+	_sl.sf->Write((byte *)_sl.delta_base, strlen(_sl.delta_base));
+	delta.WriteUint32(base.size);
+	delta.WriteUint32((uint32)(base.hash >> 32));
+	delta.WriteUint32((uint32)base.hash);
+	delta.WriteUint32(size);
+
+	byte buf[DELTA_REGION_SIZE];
+	const SmallVector<ChunkIndexEntry, 64> &chunks = dumper->chunks;
+	for (uint i = 0; i < chunks.Length(); i++) {
+		uint32 offset = (uint32)chunks[i].offset;
+		uint32 len = (uint32)(i + 1 < chunks.Length() ? chunks[i + 1].offset : size) - offset;
+
+		/* Only chunks that did not change in length are compared region by region. */
+		uint j = 0;
+		uint region = 0;
+		for (; j < base.chunks.Length() && base.chunks[j].id != chunks[i].id; j++) region += DeltaSignature::GetRegionCount(base.GetLength(j));
+		if (j == base.chunks.Length() || base.GetLength(j) != len) {
+			delta.Add(DO_DATA, offset, len);
+			continue;
+		}
+
+		for (uint32 done = 0; done < len; done += DELTA_REGION_SIZE, region++) {
+			uint32 region_len = min<uint32>(DELTA_REGION_SIZE, len - done);
+			dumper->CopyTo(offset + done, buf, region_len);
+			if (DeltaHash(buf, region_len) == base.regions[region]) {
+				delta.Add(DO_COPY, (uint32)base.chunks[j].offset + done, region_len);
+			} else {
+				delta.Add(DO_DATA, offset + done, region_len);
+			}
+		}
+	}
+	delta.Finish();
+	_sl.sf->Finish();
+	return true;
+}
+
+/**
+ * Write the savegame in memory as full savegame to the base of delta
+ * autosaves, together with its signature.
+ * @param fmt         The format to compress the base with.
+ * @param compression The level of compression.
+ * @return Whether the base and its signature have been written.
+ */
+static bool SaveDeltaBaseToDisk(const SaveLoadFormat *fmt, byte compression)
+{
+	FILE *fh = FioFOpenFile(_sl.delta_base, "wb", AUTOSAVE_DIR);
+	if (fh == NULL) {
+		DEBUG(sl, 0, "Cannot write the base '%s' for delta autosaves", _sl.delta_base);
+		return false;
+	}
+
+	/* The base has its own filter chain; the one of the autosave itself is restored afterwards. */
+	SaveFilter *sf = _sl.sf;
+	_sl.sf = new FileWriter(fh);
+	try {
+		uint32 hdr[2] = { fmt->tag, TO_BE32(SAVEGAME_VERSION << 16) };
+		_sl.sf->Write((byte *)hdr, sizeof(hdr));
+
+		_sl.sf = fmt->init_write(_sl.sf, compression);
+		_sl.dumper->Flush(_sl.sf);
+		delete _sl.sf;
+	} catch (...) {
+		delete _sl.sf;
+		_sl.sf = sf;
+		throw;
+	}
+	_sl.sf = sf;
+
+	DeltaSignature signature;
+	if (!signature.Save(_sl.delta_base, _sl.dumper)) {
+		DEBUG(sl, 0, "Cannot write the signature for delta autosaves of '%s'", _sl.delta_base);
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Decide whether an autosave is written as a delta against the current
+ * base, or whether a new base is written first. The autosaves themselves
+ * are always deltas; the bases are full savegames with names of their own,
+ * so the rotation of the autosaves never overwrites a base. The bases
+ * rotate too, but only once no autosave still in the rotation refers to
+ * the base that is overwritten. Deltas left by an earlier run of the game
+ * may refer to a base that has been overwritten since; loading those fails.
+ */
+static void SetSaveDeltaMode()
+{
+	static uint base = 0;       ///< The number of the current base.
+	static uint deltas = 0;     ///< Number of autosaves written against the current base.
+	static bool first = true;   ///< Whether no base has been written yet.
+
+	_sl.delta_mode = SDM_NONE;
+	if (!_do_autosave || _settings_client.gui.autosave_deltas == 0) return;
+
+	uint per_base = _settings_client.gui.autosave_deltas + 1;
+	if (!first && deltas < per_base) {
+		_sl.delta_mode = SDM_DELTA;
+		deltas++;
+	} else {
+		/* The oldest autosave in the rotation was written max_num_autosaves - 1
+		 * autosaves ago; the bases of all autosaves since have to be kept. */
+		uint slots = max<uint>(_settings_client.gui.max_num_autosaves, 1);
+		uint bases = _settings_client.gui.keep_all_autosave ? UINT_MAX : CeilDiv(slots - 1, per_base) + 1;
+
+		_sl.delta_mode = SDM_BASE;
+		base = first ? 0 : (base + 1) % bases;
+		deltas = 1;
+		first = false;
+	}
+	snprintf(_sl.delta_base, lengthof(_sl.delta_base), "autosave_base%u.sav", base);
+}
+
+/* actual loader/saver function */
+void InitializeGame(uint size_x, uint size_y, bool reset_date, bool reset_settings);
+extern bool AfterLoadGame();
+extern bool LoadOldSaveGame(const char *file);
+
+/**
+ * Clear/free saveload state.
+ */
+static inline void ClearSaveLoadState()
+{
+	delete _sl.dumper;
+	_sl.dumper = NULL;
+
+	delete _sl.presaved;
+	_sl.presaved = NULL;
+
+	delete _sl.sf;
+	_sl.sf = NULL;
+
+	delete _sl.reader;
+	_sl.reader = NULL;
+
+	delete _sl.lf;
+	_sl.lf = NULL;
+
+	_sl.delta_mode = SDM_NONE;
+	_sl.format = NULL;
+}
+
+/**
+ * Update the gui accordingly when starting saving
+ * and set locks on saveload. Also turn off fast-forward cause with that
+ * saving takes Aaaaages
+ */
+static void SaveFileStart()
+{
+	_sl.ff_state = _fast_forward;
+	_fast_forward = 0;
+	if (_cursor.sprite == SPR_CURSOR_MOUSE) SetMouseCursor(SPR_CURSOR_ZZZ, PAL_NONE);
+
+	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_START);
+	_sl.saveinprogress = true;
+}
+
+/** Update the gui accordingly when saving is done and release locks on saveload. */
+static void SaveFileDone()
+{
+	if (_game_mode != GM_MENU) _fast_forward = _sl.ff_state;
+	if (_cursor.sprite == SPR_CURSOR_ZZZ) SetMouseCursor(SPR_CURSOR_MOUSE, PAL_NONE);
+
+	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_FINISH);
+	_sl.saveinprogress = false;
+}
+
+/** Set the error message from outside of the actual loading/saving of the game (AfterLoadGame and friends) */
+void SetSaveLoadError(StringID str)
+{
+	_sl.error_str = str;
+}
+
+/** Get the string representation of the error message */
+const char *GetSaveLoadErrorString()
+{
+	SetDParam(0, _sl.error_str);
+	SetDParamStr(1, _sl.extra_msg);
+
+	static char err_str[512];
+	GetString(err_str, _sl.action == SLA_SAVE ? STR_ERROR_GAME_SAVE_FAILED : STR_ERROR_GAME_LOAD_FAILED, lastof(err_str));
+	return err_str;
+}
+
+/** Show a gui message when saving has failed */
+static void SaveFileError()
+{
+	SetDParamStr(0, GetSaveLoadErrorString());
+	ShowErrorMessage(STR_JUST_RAW_STRING, INVALID_STRING_ID, WL_ERROR);
+	SaveFileDone();
+}
+
+/**
+ * Compress the savegame that has been written into memory, and write it
+ * with the filter of the savegame.
+ * @note Errors are raised with SlError.
+ */
+static void WriteSavegame()
+{
+	byte compression = _sl.compression;
+	const SaveLoadFormat *fmt = _sl.format != NULL ? _sl.format : GetSavegameFormat(_savegame_format, &compression);
+
+	/* A new base is written next to the autosave, which is then a delta against it. */
+	if (_sl.delta_mode == SDM_BASE) _sl.delta_mode = SaveDeltaBaseToDisk(fmt, compression) ? SDM_DELTA : SDM_NONE;
+
+	if (_sl.delta_mode != SDM_DELTA || !SaveDeltaToDisk(fmt, compression)) {
+		/* We have written our stuff to memory, now write it to file! */
+		uint32 hdr[2] = { fmt->tag, TO_BE32(SAVEGAME_VERSION << 16) };
+		_sl.sf->Write((byte*)hdr, sizeof(hdr));
+
+		_sl.sf = fmt->init_write(_sl.sf, compression);
+		_sl.dumper->Flush(_sl.sf);
+	}
+}
+
+/**
+ * We have written the whole game into memory, _memory_savegame, now find
+ * and appropriate compressor and start writing to file.
+ */
+static SaveOrLoadResult SaveFileToDisk(bool threaded)
+{
+	try {
+		WriteSavegame();
+
+		ClearSaveLoadState();
+
+		if (threaded) SetAsyncSaveFinish(SaveFileDone);
+
+		return SL_OK;
+	} catch (...) {
+		ClearSaveLoadState();
+
+		AsyncSaveFinishProc asfp = SaveFileDone;
+
+		/* We don't want to shout when saving is just
+		 * cancelled due to a client disconnecting. */
+		if (_sl.error_str != STR_NETWORK_ERROR_LOSTCONNECTION) {
+			/* Skip the "colour" character */
+			DEBUG(sl, 0, "%s", GetSaveLoadErrorString() + 3);
+			asfp = SaveFileError;
+		}
+
+		if (threaded) {
+			SetAsyncSaveFinish(asfp);
 		} else {
 			asfp();
 		}
@@ -2521,9 +4674,10 @@ void WaitTillSaved()
  * using the writer, either in threaded mode if possible, or single-threaded.
  * @param writer   The filter to write the savegame to.
  * @param threaded Whether to try to perform the saving asynchronously.
+ * @param file     The file \a writer writes to, or \c NULL when it does not write to a file.
  * @return Return the result of the action. #SL_OK or #SL_ERROR
  */
-static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded)
+static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded, FILE *file = NULL)
 {
 	assert(!_sl.saveinprogress);
 
@@ -2533,6 +4687,15 @@ static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded)
 	_sl_version = SAVEGAME_VERSION;
 
 	SaveViewportBeforeSaveGame();
+
+#if defined(WITH_SAVE_SNAPSHOT)
+	/* Save, compress and write autosaves in a forked process, so the game (and its clients) does not have to wait. */
+	if (file != NULL && _do_autosave && _settings_client.gui.snapshot_autosaves) {
+		if (StartSaveSnapshot(file)) return SL_OK;
+		DEBUG(sl, 1, "Cannot fork for the autosave snapshot, reverting to a normal save...");
+	}
+#endif
+
 	SlSaveChunks();
 
 	SaveFileStart();
@@ -2548,6 +4711,124 @@ static SaveOrLoadResult DoSave(SaveFilter *writer, bool threaded)
 	return SL_OK;
 }
 
+#if defined(WITH_SAVE_SNAPSHOT)
+/**
+ * Save the game into memory, compress and write it from a forked process,
+ * while the game keeps running in the parent. The fork is a copy-on-write
+ * snapshot of the game, so the parent only pays for the pages it changes.
+ * The chunks that run scripts are saved by the parent before forking, as
+ * are the viewport and any other state the game itself has to update.
+ * The parent has other threads, whose locks may be held forever in the child,
+ * so the child only saves the chunks, compresses and writes, and does so
+ * without starting threads. This relies on malloc() being usable after
+ * fork(), which is the case for the C libraries of Linux and the BSDs.
+ * @param file The file the savegame is written to.
+ * @return Whether the child took over the saving.
+ */
+static bool StartSaveSnapshot(FILE *file)
+{
+	struct stat st;
+	if (fstat(fileno(file), &st) != 0) return false;
+
+	SlPresaveChunks();
+
+	int fds[2];
+	if (pipe(fds) != 0) return false;
+
+	/* Make sure the child does not write out anything the parent buffered. */
+	fflush(NULL);
+
+	pid_t pid = fork();
+	if (pid == -1) {
+		close(fds[0]);
+		close(fds[1]);
+		return false;
+	}
+
+	if (pid == 0) {
+		/* We're the child; leave without running any of the parent's clean up. */
+		close(fds[0]);
+		NetworkCloseInheritedSockets();
+		_sl.no_threads = true;
+		bool ok;
+		try {
+			SlSaveChunks();
+			WriteSavegame();
+			ok = true;
+		} catch (...) {
+			ok = false;
+		}
+		if (!ok) {
+			/* Skip the "colour" character */
+			const char *err = GetSaveLoadErrorString() + 3;
+			if (write(fds[1], err, strlen(err)) < 0) ok = false;
+		}
+		_exit(ok ? 0 : 1);
+	}
+
+	close(fds[1]);
+	_save_snapshot_pid = pid;
+	_save_snapshot_fd = fds[0];
+	_save_snapshot_file = st;
+
+	/* The child writes the file now, the parent only has to close it. */
+	ClearSaveLoadState();
+	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_START);
+	return true;
+}
+
+/**
+ * Check whether the process writing an autosave snapshot has finished, and report when it failed.
+ * @param block Whether to wait for the process to finish.
+ */
+static void CheckSaveSnapshot(bool block)
+{
+	if (_save_snapshot_pid == -1) return;
+
+	int status;
+	pid_t res;
+	do {
+		res = waitpid(_save_snapshot_pid, &status, block ? 0 : WNOHANG);
+	} while (res == -1 && errno == EINTR);
+	if (res == 0) return;
+
+	char err[256];
+	size_t len = 0;
+	ssize_t read;
+	while (len < sizeof(err) - 1 && (read = ::read(_save_snapshot_fd, err + len, sizeof(err) - 1 - len)) > 0) len += read;
+	err[len] = '\0';
+	close(_save_snapshot_fd);
+	_save_snapshot_fd = -1;
+	_save_snapshot_pid = -1;
+
+	if (res == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		DEBUG(sl, 0, "Autosave snapshot failed: %s", len == 0 ? "process ended unexpectedly" : err);
+		ShowErrorMessage(STR_ERROR_AUTOSAVE_FAILED, INVALID_STRING_ID, WL_ERROR);
+	}
+	InvalidateWindowData(WC_STATUS_BAR, 0, SBI_SAVELOAD_FINISH);
+}
+
+/**
+ * Check whether a savegame is the file the autosave snapshot is writing.
+ * @param filename The name of the savegame.
+ * @param sb       The sub directory of the savegame.
+ * @param load     Whether the savegame is loaded, so it is looked for in the same directories as #SaveOrLoad does.
+ * @return Whether the savegame is that file.
+ */
+static bool IsSaveSnapshotFile(const char *filename, Subdirectory sb, bool load)
+{
+	Subdirectory dirs[] = { sb, SAVE_DIR, BASE_DIR, SCENARIO_DIR };
+	for (uint i = 0; i < (load ? lengthof(dirs) : 1); i++) {
+		char buf[MAX_PATH];
+		const char *path = dirs[i] == NO_DIRECTORY ? filename : FioFindFullPath(buf, lengthof(buf), dirs[i], filename);
+
+		struct stat st;
+		if (path != NULL && stat(path, &st) == 0) return st.st_dev == _save_snapshot_file.st_dev && st.st_ino == _save_snapshot_file.st_ino;
+	}
+	return false;
+}
+#endif /* WITH_SAVE_SNAPSHOT */
+
 /**
  * Save the game using a (writer) filter.
  * @param writer   The filter to write the savegame to.
@@ -2634,6 +4915,8 @@ static SaveOrLoadResult DoLoad(LoadFilter *reader, bool load_check)
 	}
 
 	_sl.lf = fmt->init_load(_sl.lf);
+	/* Decompress ahead on another thread while the chunks are parsed. */
+	_sl.lf = new ThreadedLoadFilter(_sl.lf);
 	_sl.reader = new ReadBuffer(_sl.lf);
 	_next_offs = 0;
 
@@ -2728,6 +5011,300 @@ SaveOrLoadResult LoadWithFilter(LoadFilter *reader)
 	}
 }
 
+#if defined(__GLIBC__)
+#	include <malloc.h>
+#endif
+
+/** Filter keeping the savegame in memory, for the savegame benchmark. */
+struct MemoryWriter : SaveFilter {
+	MemoryDumper *savegame; ///< Where to keep the savegame.
+
+	/**
+	 * Create the memory writer.
+	 * @param savegame Where to keep the savegame.
+	 */
+	MemoryWriter(MemoryDumper *savegame) : SaveFilter(NULL), savegame(savegame)
+	{
+	}
+
+	/* virtual */ void Write(byte *buf, size_t size)
+	{
+		this->savegame->Write(buf, size);
+	}
+};
+
+/** Filter reading a savegame kept in memory, for the savegame benchmark. */
+struct MemoryReader : LoadFilter {
+	const MemoryDumper *savegame; ///< The savegame.
+	size_t offset;                ///< How much of the savegame has been read.
+
+	/**
+	 * Create the memory reader.
+	 * @param savegame The savegame to read.
+	 */
+	MemoryReader(const MemoryDumper *savegame) : LoadFilter(NULL), savegame(savegame), offset(0)
+	{
+	}
+
+	/* virtual */ size_t Read(byte *buf, size_t size)
+	{
+		size_t len = min(size, this->savegame->GetSize() - this->offset);
+		this->savegame->CopyTo(this->offset, buf, len);
+		this->offset += len;
+		return len;
+	}
+
+	/* virtual */ void Reset()
+	{
+		this->offset = 0;
+	}
+};
+
+/**
+ * Get the resident memory of the process.
+ * @param peak Whether to get the peak since #StartPeakMemoryMeasurement instead of the current usage.
+ * @return The resident memory in KiB, or 0 when it is not known.
+ */
+static size_t GetMemoryUsage(bool peak)
+{
+	size_t usage = 0;
+#if defined(__linux__)
+	FILE *f = fopen("/proc/self/status", "r");
+	if (f == NULL) return 0;
+
+	char line[128];
+	while (fgets(line, sizeof(line), f) != NULL) {
+		unsigned long value;
+		if (peak ? sscanf(line, "VmHWM: %lu", &value) == 1 : sscanf(line, "VmRSS: %lu", &value) == 1) {
+			usage = value;
+			break;
+		}
+	}
+	fclose(f);
+#endif
+	return usage;
+}
+
+/**
+ * Reset the peak resident memory of the process to its current usage, so the
+ * peak of what follows can be measured.
+ * @return The current resident memory in KiB, or 0 when the peak cannot be measured.
+ */
+static size_t StartPeakMemoryMeasurement()
+{
+#if defined(__linux__)
+#	if defined(__GLIBC__)
+	/* Give memory freed by the previous round back, or reusing it would not count. */
+	malloc_trim(0);
+#	endif
+	FILE *f = fopen("/proc/self/clear_refs", "w");
+	if (f == NULL) return 0;
+	bool ok = fputs("5", f) >= 0;
+	ok = fclose(f) == 0 && ok;
+	if (ok) return GetMemoryUsage(false);
+#endif
+	return 0;
+}
+
+/**
+ * Benchmark saving and loading the current game with every savegame format
+ * at its lowest, default and highest compression level. The savegames are
+ * kept in memory so the disk does not influence the timings. Afterwards the
+ * time and size per chunk are reported, as measured with the uncompressed
+ * format so the compression does not show up in the chunk handlers.
+ * The peak is the most resident memory a single round of saving and loading
+ * took on top of what was in use before that round, so the memory of the
+ * game itself is not part of it. It is only known on Linux.
+ * @param rounds How often to save and load the game with every format and level.
+ * @return Whether every savegame could be saved and loaded again.
+ */
+bool BenchmarkSaveLoad(uint rounds)
+{
+	SmallVector<ChunkTiming, 64> timings;
+	SmallVector<ChunkTiming, 64> chunks;
+	bool ok = true;
+
+	printf("%-8s %5s %10s %10s %12s %12s %7s %12s\n", "format", "level", "save [ms]", "load [ms]", "raw [KiB]", "size [KiB]", "ratio", "peak [KiB]");
+	for (const SaveLoadFormat *fmt = _saveload_formats; ok && fmt != endof(_saveload_formats); fmt++) {
+		if (fmt->init_write == NULL) continue;
+
+		const byte levels[] = { fmt->min_compression, fmt->default_compression, fmt->max_compression };
+		for (uint l = 0; ok && l < lengthof(levels); l++) {
+			if (l > 0 && levels[l] == levels[l - 1]) continue;
+
+			uint64 save_time = 0;
+			uint64 load_time = 0;
+			size_t raw = 0;
+			size_t size = 0;
+			size_t peak = 0;
+			bool peak_known = true;
+			_chunk_timings = strcmp(fmt->name, "none") == 0 ? &chunks : &timings;
+
+			for (uint r = 0; ok && r < rounds; r++) {
+				size_t before = StartPeakMemoryMeasurement();
+				peak_known = peak_known && before != 0;
+				MemoryDumper *savegame = new MemoryDumper();
+
+				_sl.format = fmt;
+				_sl.compression = levels[l];
+				uint64 start = GetTickProfilerTime();
+				ok = SaveWithFilter(new MemoryWriter(savegame), false) == SL_OK;
+				save_time += GetTickProfilerTime() - start;
+				if (!ok) {
+					DEBUG(sl, 0, "Saving with '%s' failed: %s", fmt->name, GetSaveLoadErrorString() + 3);
+					delete savegame;
+					break;
+				}
+
+				raw = 0;
+				for (const ChunkTiming *t = _chunk_timings->Begin(); t != _chunk_timings->End(); t++) raw += t->bytes;
+				size = savegame->GetSize();
+
+				start = GetTickProfilerTime();
+				ok = LoadWithFilter(new MemoryReader(savegame)) == SL_OK;
+				load_time += GetTickProfilerTime() - start;
+				if (!ok) DEBUG(sl, 0, "Loading with '%s' failed: %s", fmt->name, GetSaveLoadErrorString() + 3);
+				delete savegame;
+
+				size_t after = GetMemoryUsage(true);
+				if (after > before) peak = max(peak, after - before);
+			}
+			_chunk_timings = NULL;
+			if (!ok) break;
+
+			char peak_str[16] = "-";
+			if (peak_known) snprintf(peak_str, lengthof(peak_str), "%u", (uint)peak);
+			printf("%-8s %5u %10.1f %10.1f %12.1f %12.1f %6.1f%% %12s\n", fmt->name, levels[l],
+					save_time / 1000.0 / rounds, load_time / 1000.0 / rounds, raw / 1024.0, size / 1024.0,
+					raw == 0 ? 0.0 : size * 100.0 / raw, peak_str);
+		}
+	}
+
+	if (chunks.Length() != 0) {
+		printf("\n%-5s %10s %10s %12s\n", "chunk", "save [us]", "load [us]", "bytes");
+		for (const ChunkTiming *t = chunks.Begin(); t != chunks.End(); t++) {
+			printf("%c%c%c%c  %10.1f %10.1f %12u\n", t->id >> 24, t->id >> 16, t->id >> 8, t->id,
+					(double)t->save_time / rounds, (double)t->load_time / rounds, (uint)t->bytes);
+		}
+	}
+
+	return ok;
+}
+
+/**
+ * Read the chunk index of a savegame in one of the block formats.
+ * @param fh      The savegame.
+ * @param begin   Offset of the savegame header in the file.
+ * @param version Output for the savegame version, as stored in the header.
+ * @param codec   Output for the compression of the blocks.
+ * @param offsets Output for the offsets of the blocks, relative to the codec tag.
+ * @param chunks  Output for the chunks in the savegame, ending with the terminator.
+ * @return Whether the savegame has a valid chunk index.
+ */
+static bool ReadChunkIndex(FILE *fh, long begin, uint32 *version, const BlockCodec **codec, SmallVector<uint64, 64> *offsets, SmallVector<ChunkIndexEntry, 64> *chunks)
+{
+	uint32 hdr[2];
+	if (fseek(fh, begin, SEEK_SET) != 0 || fread(hdr, sizeof(hdr), 1, fh) != 1 || hdr[0] != TO_BE32X('OTTM')) return false;
+	*version = TO_BE32(hdr[1]);
+	/* Leave reporting this to the normal loading. */
+	if ((*version >> 16) > SAVEGAME_VERSION) return false;
+
+	uint32 tag;
+	if (fread(&tag, sizeof(tag), 1, fh) != 1) return false;
+	*codec = NULL;
+	for (const BlockCodec * const *c = _block_codecs; *c != NULL; c++) {
+		if ((*c)->tag == tag) *codec = *c;
+	}
+	if (*codec == NULL) return false;
+
+	/* The trailer with the offset of the chunk index. */
+	uint64 index_offset;
+	if (fseek(fh, -(long)(sizeof(index_offset) + sizeof(tag)), SEEK_END) != 0) return false;
+	long trailer = ftell(fh) - (begin + sizeof(hdr));
+	if (!ReadBigEndianUint64(fh, &index_offset) || fread(&tag, sizeof(tag), 1, fh) != 1 || tag != TO_BE32X('OTTI')) return false;
+	if (trailer <= 0 || index_offset >= (uint64)trailer) return false;
+
+	if (fseek(fh, begin + sizeof(hdr) + index_offset, SEEK_SET) != 0) return false;
+	if (fread(&tag, sizeof(tag), 1, fh) != 1 || tag != TO_BE32X('OTTI')) return false;
+
+	uint32 count;
+	if (!ReadBigEndianUint32(fh, &count) || count > index_offset / 8) return false;
+	offsets->Clear();
+	for (uint i = 0; i < count; i++) {
+		uint64 *offset = offsets->Append();
+		if (!ReadBigEndianUint64(fh, offset) || *offset >= index_offset) return false;
+	}
+
+	if (!ReadBigEndianUint32(fh, &count) || count == 0 || count > (uint64)trailer / 12) return false;
+	chunks->Clear();
+	for (uint i = 0; i < count; i++) {
+		ChunkIndexEntry *entry = chunks->Append();
+		if (!ReadBigEndianUint32(fh, &entry->id) || !ReadBigEndianUint64(fh, &entry->offset)) return false;
+		if (i > 0 && entry->offset < entry[-1].offset) return false;
+	}
+
+	/* The terminator has to be the last chunk, and within the blocks. */
+	const ChunkIndexEntry *last = chunks->End() - 1;
+	return last->id == 0 && last->offset < (uint64)offsets->Length() * BLOCK_SIZE;
+}
+
+/**
+ * Check a savegame for the load dialog or the console by only decompressing
+ * the blocks with the chunks that have a #ChunkHandler::load_check_proc.
+ * This needs the chunk index of the block formats.
+ * @param fh The savegame.
+ * @return Whether the savegame has been checked. When not, the position in
+ *         the file has been restored and the caller keeps owning it.
+ */
+static bool LoadCheckWithChunkIndex(FILE *fh)
+{
+	long begin = ftell(fh);
+
+	uint32 version;
+	const BlockCodec *codec;
+	SmallVector<uint64, 64> offsets;
+	SmallVector<ChunkIndexEntry, 64> chunks;
+	if (begin < 0 || !ReadChunkIndex(fh, begin, &version, &codec, &offsets, &chunks)) {
+		clearerr(fh);
+		if (begin >= 0) fseek(fh, begin, SEEK_SET);
+		return false;
+	}
+
+	/* Clear previous check data */
+	_load_check_data.Clear();
+	/* Mark SL_LOAD_CHECK as supported for this savegame. */
+	_load_check_data.checkable = true;
+
+	_sl_version = version >> 16;
+	_sl_minor_version = (version >> 8) & 0xFF;
+	DEBUG(sl, 1, "Checking savegame version %d through its chunk index", _sl_version);
+
+	ChunkIndexLoadFilter *lf = new ChunkIndexLoadFilter(new FileReader(fh), begin + 2 * sizeof(uint32), codec);
+	lf->offsets = offsets;
+	_sl.lf = lf;
+
+	for (const ChunkIndexEntry *entry = chunks.Begin(); entry->id != 0; entry++) {
+		const ChunkHandler *ch = SlFindChunkHandler(entry->id);
+		if (ch == NULL) SlErrorCorrupt("Unknown chunk type");
+		if (ch->load_check_proc == NULL) continue;
+
+		DEBUG(sl, 2, "Loading chunk %c%c%c%c", entry->id >> 24, entry->id >> 16, entry->id >> 8, entry->id);
+
+		lf->Seek(entry->offset, entry[1].offset);
+		_sl.reader = new ReadBuffer(lf);
+		if (SlReadUint32() != entry->id) SlErrorCorrupt("Chunk index does not match the chunks");
+		SlLoadCheckChunk(ch);
+		delete _sl.reader;
+		_sl.reader = NULL;
+	}
+
+	ClearSaveLoadState();
+
+	_savegame_type = SGT_OTTD;
+	_load_check_data.grf_compatibility = IsGoodGRFConfigList(_load_check_data.grfconfig);
+	return true;
+}
+
 /**
  * Main Save or Load function where the high-level saveload functions are
  * handled. It opens the savegame, selects format and checks versions
@@ -2745,6 +5322,14 @@ SaveOrLoadResult SaveOrLoad(const char *filename, int mode, Subdirectory sb, boo
 		if (!_do_autosave) ShowErrorMessage(STR_ERROR_SAVE_STILL_IN_PROGRESS, INVALID_STRING_ID, WL_ERROR);
 		return SL_OK;
 	}
+#if defined(WITH_SAVE_SNAPSHOT)
+	if (_save_snapshot_pid != -1 && mode == SL_SAVE && _do_autosave) {
+		DEBUG(sl, 1, "Previous autosave snapshot is still being written, skipping this autosave");
+		return SL_OK;
+	}
+	/* Do not touch the savegame the snapshot is still writing. */
+	if (_save_snapshot_pid != -1 && IsSaveSnapshotFile(filename, sb, mode != SL_SAVE)) CheckSaveSnapshot(true);
+#endif
 	WaitTillSaved();
 
 	try {
@@ -2791,13 +5376,15 @@ SaveOrLoadResult SaveOrLoad(const char *filename, int mode, Subdirectory sb, boo
 		if (mode == SL_SAVE) { // SAVE game
 			DEBUG(desync, 1, "save: %08x; %02x; %s", _date, _date_fract, filename);
 			if (_network_server || !_settings_client.gui.threaded_saves) threaded = false;
+			SetSaveDeltaMode();
 
-			return DoSave(new FileWriter(fh), threaded);
+			return DoSave(new FileWriter(fh), threaded, fh);
 		}
 
 		/* LOAD game */
 		assert(mode == SL_LOAD || mode == SL_LOAD_CHECK);
 		DEBUG(desync, 1, "load: %s", filename);
+		if (mode == SL_LOAD_CHECK && LoadCheckWithChunkIndex(fh)) return SL_OK;
 		return DoLoad(new FileReader(fh), mode == SL_LOAD_CHECK);
 	} catch (...) {
 		ClearSaveLoadState();
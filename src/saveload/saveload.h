@@ -53,6 +53,7 @@ void DoExitSave();
 
 SaveOrLoadResult SaveWithFilter(struct SaveFilter *writer, bool threaded);
 SaveOrLoadResult LoadWithFilter(struct LoadFilter *reader);
+bool BenchmarkSaveLoad(uint rounds);
 
 typedef void ChunkSaveLoadProc();
 typedef void AutolengthProc(void *arg);
@@ -98,6 +99,7 @@ enum ChunkType {
 	CH_TYPE_MASK    =  3,
 	CH_LAST         =  8, ///< Last chunk in this array.
 	CH_AUTO_LENGTH  = 16,
+	CH_RUNS_SCRIPTS = 32, ///< The save procedure runs scripts, so it cannot be run by the process writing an autosave snapshot.
 };
 
 /**
@@ -190,6 +192,7 @@ enum SaveLoadTypes {
 	SL_ARR         =  2, ///< Save/load an array.
 	SL_STR         =  3, ///< Save/load a string.
 	SL_LST         =  4, ///< Save/load a list.
+	SL_DEQUE       =  5, ///< Save/load a SmallDeque of pointers.
 	/* non-normal save-load types */
 	SL_WRITEBYTE   =  8,
 	SL_VEH_INCLUDE =  9,
@@ -281,6 +284,16 @@ typedef SaveLoad SaveLoadGlobVarList;
  */
 #define SLE_CONDLST(base, variable, type, from, to) SLE_GENERAL(SL_LST, base, variable, type, 0, from, to)
 
+/**
+ * Storage of a deque in some savegame versions.
+ * @param base     Name of the class or struct containing the deque.
+ * @param variable Name of the variable in the class or struct referenced by \a base.
+ * @param type     Storage of the data in memory and in the savegame.
+ * @param from     First savegame version that has the deque.
+ * @param to       Last savegame version that has the deque.
+ */
+#define SLE_CONDDEQUE(base, variable, type, from, to) SLE_GENERAL(SL_DEQUE, base, variable, type, 0, from, to)
+
 /**
  * Storage of a variable in every version of a savegame.
  * @param base     Name of the class or struct containing the variable.
@@ -323,6 +336,14 @@ typedef SaveLoad SaveLoadGlobVarList;
  */
 #define SLE_LST(base, variable, type) SLE_CONDLST(base, variable, type, 0, SL_MAX_VERSION)
 
+/**
+ * Storage of a deque in every savegame version.
+ * @param base     Name of the class or struct containing the deque.
+ * @param variable Name of the variable in the class or struct referenced by \a base.
+ * @param type     Storage of the data in memory and in the savegame.
+ */
+#define SLE_DEQUE(base, variable, type) SLE_CONDDEQUE(base, variable, type, 0, SL_MAX_VERSION)
+
 /**
  * Empty space in every savegame version.
  * @param length Length of the empty space.
@@ -404,6 +425,15 @@ typedef SaveLoad SaveLoadGlobVarList;
  */
 #define SLEG_CONDLST(variable, type, from, to) SLEG_GENERAL(SL_LST, variable, type, 0, from, to)
 
+/**
+ * Storage of a global deque in some savegame versions.
+ * @param variable Name of the global variable.
+ * @param type     Storage of the data in memory and in the savegame.
+ * @param from     First savegame version that has the deque.
+ * @param to       Last savegame version that has the deque.
+ */
+#define SLEG_CONDDEQUE(variable, type, from, to) SLEG_GENERAL(SL_DEQUE, variable, type, 0, from, to)
+
 /**
  * Storage of a global variable in every savegame version.
  * @param variable Name of the global variable.
@@ -538,7 +568,10 @@ void SlWriteByte(byte b);
 
 void SlGlobList(const SaveLoadGlobVarList *sldg);
 void SlArray(void *array, size_t length, VarType conv);
+void SlStridedBytes(void *ptr, size_t stride, size_t count);
+void SlStridedUint16(void *ptr, size_t stride, size_t count);
 void SlObject(void *object, const SaveLoad *sld);
+void SlCompiledObject(void *object, const SaveLoad *sld);
 bool SlObjectMember(void *object, const SaveLoad *sld);
 void NORETURN SlError(StringID string, const char *extra_msg = NULL);
 void NORETURN SlErrorCorrupt(const char *msg);
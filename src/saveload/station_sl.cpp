@@ -237,7 +237,7 @@ static const SaveLoad _station_speclist_desc[] = {
 	SLE_END()
 };
 
-std::list<CargoPacket *> _packets;
+StationCargoBucket _packets;
 uint32 _num_dests;
 
 struct FlowSaveLoad {
@@ -278,7 +278,7 @@ const SaveLoad *GetGoodsDesc()
 		SLEG_CONDVAR(            _cargo_feeder_share,  SLE_FILE_U32 | SLE_VAR_I64, 14, 64),
 		SLEG_CONDVAR(            _cargo_feeder_share,  SLE_INT64,                  65, 67),
 		 SLE_CONDVAR(GoodsEntry, amount_fract,         SLE_UINT8,                 150, SL_MAX_VERSION),
-		SLEG_CONDLST(            _packets,             REF_CARGO_PACKET,           68, 182),
+		SLEG_CONDDEQUE(          _packets,             REF_CARGO_PACKET,           68, 182),
 		SLEG_CONDVAR(            _num_dests,           SLE_UINT32,                183, SL_MAX_VERSION),
 		 SLE_CONDVAR(GoodsEntry, cargo.reserved_count, SLE_UINT,                  181, SL_MAX_VERSION),
 		 SLE_CONDVAR(GoodsEntry, link_graph,           SLE_UINT16,                183, SL_MAX_VERSION),
@@ -291,11 +291,11 @@ const SaveLoad *GetGoodsDesc()
 	return goods_desc;
 }
 
-typedef std::pair<const StationID, std::list<CargoPacket *> > StationCargoPair;
+typedef std::pair<const StationID, StationCargoBucket> StationCargoPair;
 
 static const SaveLoad _cargo_list_desc[] = {
 	SLE_VAR(StationCargoPair, first,  SLE_UINT16),
-	SLE_LST(StationCargoPair, second, REF_CARGO_PACKET),
+	SLE_DEQUE(StationCargoPair, second, REF_CARGO_PACKET),
 	SLE_END()
 };
 
@@ -309,7 +309,7 @@ static void SwapPackets(GoodsEntry *ge)
 	StationCargoPacketMap &ge_packets = const_cast<StationCargoPacketMap &>(*ge->cargo.Packets());
 
 	if (_packets.empty()) {
-		std::map<StationID, std::list<CargoPacket *> >::iterator it(ge_packets.find(INVALID_STATION));
+		StationCargoPacketMap::MapIterator it(ge_packets.find(INVALID_STATION));
 		if (it == ge_packets.end()) {
 			return;
 		} else {
@@ -464,7 +464,7 @@ const SaveLoad *GetBaseStationDescription()
 static void RealSave_STNN(BaseStation *bst)
 {
 	bool waypoint = (bst->facilities & FACIL_WAYPOINT) != 0;
-	SlObject(bst, waypoint ? _waypoint_desc : _station_desc);
+	SlCompiledObject(bst, waypoint ? _waypoint_desc : _station_desc);
 
 	if (!waypoint) {
 		Station *st = Station::From(bst);
@@ -474,7 +474,7 @@ static void RealSave_STNN(BaseStation *bst)
 			for (FlowStatMap::const_iterator it(st->goods[i].flows.begin()); it != st->goods[i].flows.end(); ++it) {
 				_num_flows += (uint32)it->second.GetShares()->size();
 			}
-			SlObject(&st->goods[i], GetGoodsDesc());
+			SlCompiledObject(&st->goods[i], GetGoodsDesc());
 			for (FlowStatMap::const_iterator outer_it(st->goods[i].flows.begin()); outer_it != st->goods[i].flows.end(); ++outer_it) {
 				const FlowStat::SharesMap *shares = outer_it->second.GetShares();
 				uint32 sum_shares = 0;
@@ -486,17 +486,17 @@ static void RealSave_STNN(BaseStation *bst)
 					flow.restricted = inner_it->first > outer_it->second.GetUnrestricted();
 					sum_shares = inner_it->first;
 					assert(flow.share > 0);
-					SlObject(&flow, _flow_desc);
+					SlCompiledObject(&flow, _flow_desc);
 				}
 			}
 			for (StationCargoPacketMap::ConstMapIterator it(st->goods[i].cargo.Packets()->begin()); it != st->goods[i].cargo.Packets()->end(); ++it) {
-				SlObject(const_cast<StationCargoPacketMap::value_type *>(&(*it)), _cargo_list_desc);
+				SlCompiledObject(const_cast<StationCargoPacketMap::value_type *>(&(*it)), _cargo_list_desc);
 			}
 		}
 	}
 
 	for (uint i = 0; i < bst->num_specs; i++) {
-		SlObject(&bst->speclist[i], _station_speclist_desc);
+		SlCompiledObject(&bst->speclist[i], _station_speclist_desc);
 	}
 }
 
@@ -518,7 +518,7 @@ static void Load_STNN()
 		bool waypoint = (SlReadByte() & FACIL_WAYPOINT) != 0;
 
 		BaseStation *bst = waypoint ? (BaseStation *)new (index) Waypoint() : new (index) Station();
-		SlObject(bst, waypoint ? _waypoint_desc : _station_desc);
+		SlCompiledObject(bst, waypoint ? _waypoint_desc : _station_desc);
 
 		if (!waypoint) {
 			Station *st = Station::From(bst);
@@ -532,12 +532,12 @@ static void Load_STNN()
 			}
 
 			for (CargoID i = 0; i < NUM_CARGO; i++) {
-				SlObject(&st->goods[i], GetGoodsDesc());
+				SlCompiledObject(&st->goods[i], GetGoodsDesc());
 				FlowSaveLoad flow;
 				FlowStat *fs = NULL;
 				StationID prev_source = INVALID_STATION;
 				for (uint32 j = 0; j < _num_flows; ++j) {
-					SlObject(&flow, _flow_desc);
+					SlCompiledObject(&flow, _flow_desc);
 					if (fs == NULL || prev_source != flow.source) {
 						fs = &(st->goods[i].flows.insert(std::make_pair(flow.source, FlowStat(flow.via, flow.share, flow.restricted))).first->second);
 					} else {
@@ -550,7 +550,7 @@ static void Load_STNN()
 				} else {
 					StationCargoPair pair;
 					for (uint j = 0; j < _num_dests; ++j) {
-						SlObject(&pair, _cargo_list_desc);
+						SlCompiledObject(&pair, _cargo_list_desc);
 						const_cast<StationCargoPacketMap &>(*(st->goods[i].cargo.Packets()))[pair.first].swap(pair.second);
 						assert(pair.second.empty());
 					}
@@ -562,7 +562,7 @@ static void Load_STNN()
 			/* Allocate speclist memory when loading a game */
 			bst->speclist = CallocT<StationSpecList>(bst->num_specs);
 			for (uint i = 0; i < bst->num_specs; i++) {
-				SlObject(&bst->speclist[i], _station_speclist_desc);
+				SlCompiledObject(&bst->speclist[i], _station_speclist_desc);
 			}
 		}
 	}
@@ -579,21 +579,21 @@ static void Ptrs_STNN()
 			GoodsEntry *ge = &st->goods[i];
 			if (IsSavegameVersionBefore(183)) {
 				SwapPackets(ge);
-				SlObject(ge, GetGoodsDesc());
+				SlCompiledObject(ge, GetGoodsDesc());
 				SwapPackets(ge);
 			} else {
-				SlObject(ge, GetGoodsDesc());
+				SlCompiledObject(ge, GetGoodsDesc());
 				for (StationCargoPacketMap::ConstMapIterator it = ge->cargo.Packets()->begin(); it != ge->cargo.Packets()->end(); ++it) {
-					SlObject(const_cast<StationCargoPair *>(&(*it)), _cargo_list_desc);
+					SlCompiledObject(const_cast<StationCargoPair *>(&(*it)), _cargo_list_desc);
 				}
 			}
 		}
-		SlObject(st, _station_desc);
+		SlCompiledObject(st, _station_desc);
 	}
 
 	Waypoint *wp;
 	FOR_ALL_WAYPOINTS(wp) {
-		SlObject(wp, _waypoint_desc);
+		SlCompiledObject(wp, _waypoint_desc);
 	}
 }
 
@@ -303,6 +303,9 @@ void AfterLoadVehicles(bool part_of_load)
 		}
 	}
 
+	/* The chains were linked without Vehicle::SetNext, so redo the tick lists. */
+	RebuildVehicleTickLists();
+
 	if (part_of_load) {
 		if (IsSavegameVersionBefore(105)) {
 			/* Before 105 there was no order for shared orders, thus it messed up horribly */
@@ -615,7 +618,7 @@ const SaveLoad *GetVehicleDescription(VehicleType vt)
 		     SLE_VAR(Vehicle, cargo_cap,             SLE_UINT16),
 		 SLE_CONDVAR(Vehicle, refit_cap,             SLE_UINT16,                 182, SL_MAX_VERSION),
 		SLEG_CONDVAR(         _cargo_count,          SLE_UINT16,                   0,  67),
-		 SLE_CONDLST(Vehicle, cargo.packets,         REF_CARGO_PACKET,            68, SL_MAX_VERSION),
+		SLE_CONDDEQUE(Vehicle, cargo.packets,        REF_CARGO_PACKET,            68, SL_MAX_VERSION),
 		 SLE_CONDARR(Vehicle, cargo.action_counts,   SLE_UINT, VehicleCargoList::NUM_MOVE_TO_ACTION, 181, SL_MAX_VERSION),
 		 SLE_CONDVAR(Vehicle, cargo_age_counter,     SLE_UINT16,                 162, SL_MAX_VERSION),
 
@@ -872,7 +875,7 @@ static void Save_VEHS()
 	/* Write the vehicles */
 	FOR_ALL_VEHICLES(v) {
 		SlSetArrayIndex(v->index);
-		SlObject(v, GetVehicleDescription(v->type));
+		SlCompiledObject(v, GetVehicleDescription(v->type));
 	}
 }
 
@@ -898,7 +901,7 @@ void Load_VEHS()
 			default: SlErrorCorrupt("Invalid vehicle type");
 		}
 
-		SlObject(v, GetVehicleDescription(vtype));
+		SlCompiledObject(v, GetVehicleDescription(vtype));
 
 		if (_cargo_count != 0 && IsCompanyBuildableVehicleType(v) && CargoPacket::CanAllocateItem()) {
 			/* Don't construct the packet with station here, because that'll fail with old savegames */
@@ -929,7 +932,7 @@ static void Ptrs_VEHS()
 {
 	Vehicle *v;
 	FOR_ALL_VEHICLES(v) {
-		SlObject(v, GetVehicleDescription(v->type));
+		SlCompiledObject(v, GetVehicleDescription(v->type));
 	}
 }
 
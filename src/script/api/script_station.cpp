@@ -67,15 +67,7 @@
 	if (!IsValidStation(via_station_id) && via_station_id != STATION_INVALID) return -1;
 	if (!ScriptCargo::IsValidCargo(cargo_id)) return -1;
 
-	const StationCargoList &cargo_list = ::Station::Get(station_id)->goods[cargo_id].cargo;
-	uint16 cargo_count = 0;
-	std::pair<StationCargoList::ConstIterator, StationCargoList::ConstIterator> range = cargo_list.Packets()->equal_range(via_station_id);
-	for (StationCargoList::ConstIterator it = range.first; it != range.second; it++) {
-		CargoPacket *cp = *it;
-		cargo_count += cp->Count();
-	}
-
-	return cargo_count;
+	return (uint16)::Station::Get(station_id)->goods[cargo_id].cargo.AvailableViaCount(via_station_id);
 }
 
 /* static */ bool ScriptStation::HasCargoRating(StationID station_id, CargoID cargo_id)
@@ -103,6 +103,8 @@ struct GUISettings {
 	bool   disable_unsuitable_building;      ///< disable infrastructure building when no suitable vehicles are available
 	byte   autosave;                         ///< how often should we do autosaves?
 	bool   threaded_saves;                   ///< should we do threaded saves?
+	bool   snapshot_autosaves;               ///< should autosaves be compressed and written by a forked process? (not on Windows and OS X)
+	uint8  autosave_deltas;                  ///< how many autosaves follow each autosave that writes a new base for delta autosaves (0 = no delta autosaves)
 	bool   keep_all_autosave;                ///< name the autosave in a different way
 	bool   autosave_on_exit;                 ///< save an autosave when you quit the game, but do not ask "Do you really want to quit?"
 	uint8  date_format_in_default_names;     ///< should the default savegame/screenshot name use long dates (31th Dec 2008), short dates (31-12-2008) or ISO dates (2008-12-31)
@@ -38,6 +38,12 @@ public:
 	 */
 	virtual void Join() = 0;
 
+	/**
+	 * Check whether the calling thread is this thread.
+	 * @return True when called from within this thread.
+	 */
+	virtual bool IsCurrent() = 0;
+
 	/**
 	 * Create a thread; proc will be called as first function inside the thread,
 	 *  with optional params.
@@ -50,6 +50,14 @@ public:
 		DosWaitThread(&this->thread, DCWW_WAIT);
 		this->thread = 0;
 	}
+
+	/* virtual */ bool IsCurrent()
+	{
+		PTIB tib;
+		PPIB pib;
+		DosGetInfoBlocks(&tib, &pib);
+		return tib->tib_ptib2->tib2_ultid == this->thread;
+	}
 private:
 	/**
 	 * On thread creation, this function is called, which calls the real startup
@@ -51,6 +51,11 @@ public:
 		pthread_join(this->thread, NULL);
 		this->thread = 0;
 	}
+
+	/* virtual */ bool IsCurrent()
+	{
+		return pthread_equal(pthread_self(), this->thread) != 0;
+	}
 private:
 	/**
 	 * On thread creation, this function is called, which calls the real startup
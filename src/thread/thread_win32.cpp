@@ -66,6 +66,11 @@ public:
 		WaitForSingleObject(this->thread, INFINITE);
 	}
 
+	/* virtual */ bool IsCurrent()
+	{
+		return GetCurrentThreadId() == this->id;
+	}
+
 private:
 	/**
 	 * On thread creation, this function is called, which calls the real startup
@@ -0,0 +1,144 @@
+/* $Id$ */
+
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tick_profiler.cpp Always-on timing of the phases of the game loop. */
+
+#include "stdafx.h"
+#include "tick_profiler.h"
+#include "core/math_func.hpp"
+#include "core/mem_func.hpp"
+#include <algorithm>
+
+#ifdef WIN32
+# include <windows.h>
+#else
+# include <time.h>
+# include <sys/time.h>
+#endif
+
+/** The timing history of all phases of the game loop. */
+TickPhaseHistory _tick_profile[TP_END];
+
+/** Names of the phases, as shown in the console. */
+static const char * const _tick_phase_names[] = {
+	"animate_tiles",
+	"increase_date",
+	"tile_loop",
+	"vehicle_ticks",
+	"landscape_tick",
+	"ai",
+	"game_script",
+	"window_tick",
+	"total",
+};
+assert_compile(lengthof(_tick_phase_names) == TP_END);
+
+/**
+ * Get a monotonic timestamp with microsecond resolution. Only systems
+ * without a monotonic clock fall back to the wall clock, which can jump.
+ * @return The current time in microseconds.
+ */
+uint64 GetTickProfilerTime()
+{
+#ifdef WIN32
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0) QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return (uint64)(now.QuadPart / frequency.QuadPart) * 1000000 + (uint64)(now.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+	struct timespec tim;
+	clock_gettime(CLOCK_MONOTONIC, &tim);
+	return (uint64)tim.tv_sec * 1000000 + tim.tv_nsec / 1000;
+#else
+	struct timeval tim;
+	gettimeofday(&tim, NULL);
+	return (uint64)tim.tv_sec * 1000000 + tim.tv_usec;
+#endif
+}
+
+/**
+ * Get the name of a phase of the game loop.
+ * @param phase The phase to get the name of.
+ * @return The name.
+ */
+const char *GetTickPhaseName(TickPhase phase)
+{
+	assert(phase < TP_END);
+	return _tick_phase_names[phase];
+}
+
+/**
+ * Get the exclusive upper limit of a bucket of the histogram. The buckets
+ * grow by a factor of four, starting at 16 microseconds; the last bucket
+ * has no upper limit.
+ * @param bucket The bucket to get the limit of.
+ * @return The limit in microseconds, or UINT32_MAX for the last bucket.
+ */
+uint32 GetTickHistogramBucketLimit(uint bucket)
+{
+	assert(bucket < TICK_HISTOGRAM_BUCKETS);
+	if (bucket == TICK_HISTOGRAM_BUCKETS - 1) return UINT32_MAX;
+	return 16U << (2 * bucket);
+}
+
+/** Forget all gathered samples. */
+void TickPhaseHistory::Reset()
+{
+	this->next = 0;
+	this->count = 0;
+	this->total_time = 0;
+	this->total_count = 0;
+}
+
+/**
+ * Get the average duration over all samples since the last reset.
+ * @return The average in microseconds.
+ */
+uint32 TickPhaseHistory::GetAverage() const
+{
+	if (this->total_count == 0) return 0;
+	return (uint32)(this->total_time / this->total_count);
+}
+
+/**
+ * Get a percentile of the durations in the rolling history.
+ * @param percentile The percentile to get, 100 yields the maximum.
+ * @return The duration in microseconds.
+ */
+uint32 TickPhaseHistory::GetPercentile(uint percentile) const
+{
+	if (this->count == 0) return 0;
+
+	uint32 sorted[HISTORY_LENGTH];
+	MemCpyT(sorted, this->samples, this->count);
+	std::sort(sorted, sorted + this->count);
+	return sorted[min<uint>(this->count - 1, this->count * min<uint>(percentile, 100) / 100)];
+}
+
+/**
+ * Fill a histogram of the durations in the rolling history.
+ * @param buckets The number of samples per bucket, see #GetTickHistogramBucketLimit.
+ */
+void TickPhaseHistory::GetHistogram(uint16 buckets[TICK_HISTOGRAM_BUCKETS]) const
+{
+	MemSetT(buckets, 0, TICK_HISTOGRAM_BUCKETS);
+	for (uint i = 0; i < this->count; i++) {
+		uint bucket = 0;
+		while (bucket < TICK_HISTOGRAM_BUCKETS - 1 && this->samples[i] >= GetTickHistogramBucketLimit(bucket)) bucket++;
+		buckets[bucket]++;
+	}
+}
+
+/** Forget the gathered samples of all phases. */
+void ResetTickProfiler()
+{
+	for (uint i = 0; i < TP_END; i++) _tick_profile[i].Reset();
+}
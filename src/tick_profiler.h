@@ -0,0 +1,113 @@
+/* $Id$ */
+
+/*
+ * This file is part of OpenTTD.
+ * OpenTTD is free software; you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, version 2.
+ * OpenTTD is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details. You should have received a copy of the GNU General Public License along with OpenTTD. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file tick_profiler.h Always-on timing of the phases of the game loop. */
+
+#ifndef TICK_PROFILER_H
+#define TICK_PROFILER_H
+
+/** The phases of StateGameLoop that are timed individually. */
+enum TickPhase {
+	TP_ANIMATE_TILES,   ///< AnimateAnimatedTiles.
+	TP_INCREASE_DATE,   ///< IncreaseDate, including the daily/monthly/yearly loops.
+	TP_TILE_LOOP,       ///< RunTileLoop.
+	TP_VEHICLE_TICKS,   ///< CallVehicleTicks.
+	TP_LANDSCAPE_TICK,  ///< CallLandscapeTick.
+	TP_AI,              ///< AI::GameLoop.
+	TP_GAME_SCRIPT,     ///< Game::GameLoop.
+	TP_WINDOW_TICK,     ///< CallWindowTickEvent.
+	TP_TOTAL,           ///< The whole of StateGameLoop.
+	TP_END,             ///< Must ALWAYS be on the end of this list!! (period)
+};
+
+/** Number of buckets in the histogram of a #TickPhaseHistory. */
+static const uint TICK_HISTOGRAM_BUCKETS = 8;
+
+/**
+ * Rolling history of the durations of a single phase of the game loop.
+ * The last #HISTORY_LENGTH samples are kept, from which the statistics
+ * are derived on request; recording a sample is constant time.
+ */
+struct TickPhaseHistory {
+	static const uint HISTORY_LENGTH = 256; ///< Number of samples kept, a bit more than three game days.
+
+	uint32 samples[HISTORY_LENGTH]; ///< Ring buffer with the durations in microseconds.
+	uint next;                      ///< Position in #samples the next sample will be written to.
+	uint count;                     ///< Number of valid samples in #samples.
+	uint64 total_time;              ///< Sum of all durations since the last reset, in microseconds.
+	uint64 total_count;             ///< Number of durations since the last reset.
+
+	void Reset();
+
+	/**
+	 * Add a sample to the history.
+	 * @param duration The duration of the phase in microseconds.
+	 */
+	inline void Add(uint32 duration)
+	{
+		this->samples[this->next] = duration;
+		this->next = (this->next + 1) % HISTORY_LENGTH;
+		if (this->count < HISTORY_LENGTH) this->count++;
+		this->total_time += duration;
+		this->total_count++;
+	}
+
+	uint32 GetAverage() const;
+	uint32 GetPercentile(uint percentile) const;
+	void GetHistogram(uint16 buckets[TICK_HISTOGRAM_BUCKETS]) const;
+};
+
+extern TickPhaseHistory _tick_profile[TP_END];
+
+uint64 GetTickProfilerTime();
+const char *GetTickPhaseName(TickPhase phase);
+uint32 GetTickHistogramBucketLimit(uint bucket);
+void ResetTickProfiler();
+
+/**
+ * Helper for timing consecutive phases of the game loop. Every call to
+ * #Next attributes the time since the previous mark to the given phase;
+ * upon destruction the time since construction is added to #TP_TOTAL.
+ */
+class TickPhaseTimer {
+	uint64 start; ///< Moment the timer got constructed.
+	uint64 mark;  ///< Moment the last phase ended.
+
+public:
+	/** Start timing. */
+	TickPhaseTimer() : start(GetTickProfilerTime())
+	{
+		this->mark = this->start;
+	}
+
+	/** Account the whole duration to #TP_TOTAL. */
+	~TickPhaseTimer()
+	{
+		_tick_profile[TP_TOTAL].Add((uint32)(GetTickProfilerTime() - this->start));
+	}
+
+	/**
+	 * Attribute the time since the previous phase ended to the given phase.
+	 * @param phase The phase that just ended.
+	 */
+	inline void Next(TickPhase phase)
+	{
+		uint64 now = GetTickProfilerTime();
+		_tick_profile[phase].Add((uint32)(now - this->mark));
+		this->mark = now;
+	}
+
+	/** Do not attribute the time since the previous phase ended to any phase. */
+	inline void Skip()
+	{
+		this->mark = GetTickProfilerTime();
+	}
+};
+
+#endif /* TICK_PROFILER_H */
@@ -19,6 +19,7 @@
 #include "news_func.h"
 #include "command_func.h"
 #include "company_func.h"
+#include "company_base.h"
 #include "train.h"
 #include "aircraft.h"
 #include "newgrf_debug.h"
@@ -277,6 +278,80 @@ void VehicleLengthChanged(const Vehicle *u)
 	}
 }
 
+/** List of vehicles, sorted by their index. */
+typedef SmallVector<Vehicle *, 64> VehicleTickList;
+
+/**
+ * Per vehicle type the vehicles that are the first of their chain. Only
+ * these are ticked; they take care of the other parts of their chain.
+ */
+static VehicleTickList _vehicle_tick_lists[VEH_END];
+
+/**
+ * Find the position of the first vehicle with at least the given index in a tick list.
+ * @param list  The list to search in.
+ * @param index The index to search for.
+ * @return The position in the list, or the length of the list when there is no such vehicle.
+ */
+static uint FindTickListPosition(const VehicleTickList &list, VehicleID index)
+{
+	uint begin = 0;
+	uint end = list.Length();
+	while (begin < end) {
+		uint mid = (begin + end) / 2;
+		if (list[mid]->index < index) {
+			begin = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+	return begin;
+}
+
+/**
+ * Add a vehicle that just became the first of its chain to the tick list of its type.
+ * @param v The vehicle to add.
+ */
+static void AddToTickList(Vehicle *v)
+{
+	if (v->type >= VEH_END) return;
+
+	VehicleTickList &list = _vehicle_tick_lists[v->type];
+	uint pos = FindTickListPosition(list, v->index);
+	assert(pos == list.Length() || list[pos] != v);
+
+	list.Append();
+	MemMoveT(list.Begin() + pos + 1, list.Begin() + pos, list.Length() - pos - 1);
+	list[pos] = v;
+}
+
+/**
+ * Remove a vehicle from the tick list of its type, if it is in there.
+ * @param v The vehicle to remove.
+ */
+static void RemoveFromTickList(Vehicle *v)
+{
+	if (v->type >= VEH_END) return;
+
+	VehicleTickList &list = _vehicle_tick_lists[v->type];
+	uint pos = FindTickListPosition(list, v->index);
+	if (pos < list.Length() && list[pos] == v) list.ErasePreservingOrder(pos);
+}
+
+/**
+ * Rebuild the tick lists from the vehicle chains, e.g. after loading
+ * a savegame when the chains have been set up without Vehicle::SetNext.
+ */
+void RebuildVehicleTickLists()
+{
+	for (VehicleType type = VEH_BEGIN; type != VEH_END; type++) _vehicle_tick_lists[type].Clear();
+
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) {
+		if (v->Previous() == NULL && v->type < VEH_END) *_vehicle_tick_lists[v->type].Append() = v;
+	}
+}
+
 /**
  * Vehicle constructor.
  * @param type Type of the new vehicle.
@@ -292,6 +367,8 @@ Vehicle::Vehicle(VehicleType type)
 	this->cargo_age_counter  = 1;
 	this->last_station_visited = INVALID_STATION;
 	this->last_loading_station = INVALID_STATION;
+
+	AddToTickList(this);
 }
 
 /**
@@ -303,32 +380,122 @@ byte VehicleRandomBits()
 	return GB(Random(), 0, 8);
 }
 
-/* Size of the hash, 6 = 64 x 64, 7 = 128 x 128. Larger sizes will (in theory) reduce hash
- * lookup times at the expense of memory usage. */
-const int HASH_BITS = 7;
-const int HASH_SIZE = 1 << HASH_BITS;
-const int HASH_MASK = HASH_SIZE - 1;
-const int TOTAL_HASH_SIZE = 1 << (HASH_BITS * 2);
-const int TOTAL_HASH_MASK = TOTAL_HASH_SIZE - 1;
+/* The tile hash maps the lower bits of the tile coordinates to a bucket,
+ * so every bucket covers a regular grid of tiles and areas of the map map
+ * to rectangles of buckets. It is sized to the number of vehicles and the
+ * map; once a dimension of the hash equals that of the map each bucket
+ * holds the vehicles of exactly one tile. */
+static const uint MIN_TILE_HASH_BITS = 7;  ///< Minimum number of bits of the hash per axis, unless the map is smaller.
+static const uint MAX_TILE_HASH_BITS = 10; ///< Maximum number of bits of the hash per axis.
+
+static Vehicle **_vehicle_tile_hash = NULL; ///< The buckets of the tile hash.
+static uint _vehicle_tile_hash_bits_x = 0;  ///< Number of bits of the X coordinate used for the hash.
+static uint _vehicle_tile_hash_bits_y = 0;  ///< Number of bits of the Y coordinate used for the hash.
+static uint _vehicle_tile_hash_count = 0;   ///< Number of vehicles in the tile hash.
+static uint _vehicle_tile_hash_used = 0;    ///< Number of buckets of the tile hash with at least one vehicle.
+
+/**
+ * Get the bucket of the tile hash for a tile coordinate; coordinates wrap around.
+ * @param x The X coordinate of the tile.
+ * @param y The Y coordinate of the tile.
+ * @return The bucket.
+ */
+static inline Vehicle **GetTileHashBucket(uint x, uint y)
+{
+	return &_vehicle_tile_hash[((y & ((1 << _vehicle_tile_hash_bits_y) - 1)) << _vehicle_tile_hash_bits_x) + (x & ((1 << _vehicle_tile_hash_bits_x) - 1))];
+}
+
+/**
+ * Determine the size of the tile hash for the current map and a number of vehicles.
+ * There will be at least a bucket per vehicle, as long as the map and
+ * #MAX_TILE_HASH_BITS allow that.
+ * @param vehicles The number of vehicles to size the hash for.
+ * @param[out] bits_x The number of bits of the X coordinate to use.
+ * @param[out] bits_y The number of bits of the Y coordinate to use.
+ */
+static void GetTileHashSize(uint vehicles, uint *bits_x, uint *bits_y)
+{
+	uint bits = Clamp(FindLastBit(max(vehicles, 1U)) + 1, 2 * MIN_TILE_HASH_BITS, 2 * MAX_TILE_HASH_BITS);
+
+	/* Split the bits over the axes; whatever does not fit in one axis goes to the other. */
+	*bits_x = min(MapLogX(), (bits + 1) / 2);
+	*bits_y = min(MapLogY(), min(MAX_TILE_HASH_BITS, bits - *bits_x));
+	*bits_x = min(MapLogX(), min(MAX_TILE_HASH_BITS, bits - *bits_y));
+}
+
+static void UpdateVehicleTileHash(Vehicle *v, bool remove);
 
-/* Resolution of the hash, 0 = 1*1 tile, 1 = 2*2 tiles, 2 = 4*4 tiles, etc.
- * Profiling results show that 0 is fastest. */
-const int HASH_RES = 0;
+/**
+ * (Re)allocate the tile hash with the given size and move all vehicles that
+ * were in the old hash into the new one.
+ * @param bits_x The number of bits of the X coordinate to use.
+ * @param bits_y The number of bits of the Y coordinate to use.
+ */
+static void ResizeVehicleTileHash(uint bits_x, uint bits_y)
+{
+	free(_vehicle_tile_hash);
+	_vehicle_tile_hash = CallocT<Vehicle *>(1 << (bits_x + bits_y));
+	_vehicle_tile_hash_bits_x = bits_x;
+	_vehicle_tile_hash_bits_y = bits_y;
+	_vehicle_tile_hash_count = 0;
+	_vehicle_tile_hash_used = 0;
+
+	Vehicle *v;
+	FOR_ALL_VEHICLES(v) {
+		if (v->hash_tile_current == NULL) continue;
 
-static Vehicle *_vehicle_tile_hash[TOTAL_HASH_SIZE];
+		/* The old chains are gone, so simply insert it anew. */
+		v->hash_tile_current = NULL;
+		UpdateVehicleTileHash(v, false);
+	}
+}
 
-static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, void *data, VehicleFromPosProc *proc, bool find_first)
+/**
+ * Grow the tile hash when the number of vehicles outgrew it, or shrink it
+ * when the map became smaller than the hash. It is never shrunk because of
+ * fewer vehicles; that only happens when the hash gets reset.
+ */
+static void CheckVehicleTileHashSize()
 {
-	for (int y = yl; ; y = (y + (1 << HASH_BITS)) & (HASH_MASK << HASH_BITS)) {
-		for (int x = xl; ; x = (x + 1) & HASH_MASK) {
-			Vehicle *v = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
+	uint bits_x, bits_y;
+	GetTileHashSize(_vehicle_tile_hash_count, &bits_x, &bits_y);
+
+	if (bits_x + bits_y > _vehicle_tile_hash_bits_x + _vehicle_tile_hash_bits_y ||
+			_vehicle_tile_hash_bits_x > MapLogX() || _vehicle_tile_hash_bits_y > MapLogY()) {
+		ResizeVehicleTileHash(bits_x, bits_y);
+	}
+}
+
+/**
+ * Helper function for the position based vehicle searches; calls \a proc for
+ * all vehicles in the buckets covering the given rectangle of tiles.
+ * @param xl The lowest X coordinate of the tiles to search; may be out of the map.
+ * @param yl The lowest Y coordinate of the tiles to search; may be out of the map.
+ * @param xu The highest X coordinate of the tiles to search; may be out of the map.
+ * @param yu The highest Y coordinate of the tiles to search; may be out of the map.
+ * @param area If not \c NULL, only vehicles on tiles within this area are passed to \a proc.
+ * @param data Arbitrary data passed to \a proc.
+ * @param proc The proc that determines whether a vehicle will be "found".
+ * @param find_first Whether to return on the first found or iterate over
+ *                   all vehicles
+ * @return the best matching or first vehicle (depending on find_first).
+ */
+static Vehicle *VehicleFromTileHash(int xl, int yl, int xu, int yu, const TileArea *area, void *data, VehicleFromPosProc *proc, bool find_first)
+{
+	/* Do not visit a bucket twice when the rectangle is larger than the hash. */
+	uint w = min<uint>(xu - xl + 1, 1 << _vehicle_tile_hash_bits_x);
+	uint h = min<uint>(yu - yl + 1, 1 << _vehicle_tile_hash_bits_y);
+
+	for (uint y = 0; y < h; y++) {
+		for (uint x = 0; x < w; x++) {
+			Vehicle *v = *GetTileHashBucket(xl + x, yl + y);
 			for (; v != NULL; v = v->hash_tile_next) {
+				if (area != NULL && !area->Contains(v->tile)) continue;
+
 				Vehicle *a = proc(v, data);
 				if (find_first && a != NULL) return a;
 			}
-			if (x == xu) break;
 		}
-		if (y == yu) break;
 	}
 
 	return NULL;
@@ -350,13 +517,13 @@ static Vehicle *VehicleFromPosXY(int x, int y, void *data, VehicleFromPosProc *p
 {
 	const int COLL_DIST = 6;
 
-	/* Hash area to scan is from xl,yl to xu,yu */
-	int xl = GB((x - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int xu = GB((x + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS);
-	int yl = GB((y - COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
-	int yu = GB((y + COLL_DIST) / TILE_SIZE, HASH_RES, HASH_BITS) << HASH_BITS;
+	/* Tiles to scan are from xl,yl to xu,yu */
+	int xl = (x - COLL_DIST) / TILE_SIZE;
+	int xu = (x + COLL_DIST) / TILE_SIZE;
+	int yl = (y - COLL_DIST) / TILE_SIZE;
+	int yu = (y + COLL_DIST) / TILE_SIZE;
 
-	return VehicleFromTileHash(xl, yl, xu, yu, data, proc, find_first);
+	return VehicleFromTileHash(xl, yl, xu, yu, NULL, data, proc, find_first);
 }
 
 /**
@@ -406,10 +573,7 @@ bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc)
  */
 static Vehicle *VehicleFromPos(TileIndex tile, void *data, VehicleFromPosProc *proc, bool find_first)
 {
-	int x = GB(TileX(tile), HASH_RES, HASH_BITS);
-	int y = GB(TileY(tile), HASH_RES, HASH_BITS) << HASH_BITS;
-
-	Vehicle *v = _vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
+	Vehicle *v = *GetTileHashBucket(TileX(tile), TileY(tile));
 	for (; v != NULL; v = v->hash_tile_next) {
 		if (v->tile != tile) continue;
 
@@ -453,6 +617,56 @@ bool HasVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc)
 	return VehicleFromPos(tile, data, proc, true) != NULL;
 }
 
+/**
+ * Helper function for FindVehicleOnTileArea/HasVehicleOnTileArea.
+ * @note Do not call this function directly!
+ * @param ta   The area on the map.
+ * @param data Arbitrary data passed to \a proc.
+ * @param proc The proc that determines whether a vehicle will be "found".
+ * @param find_first Whether to return on the first found or iterate over
+ *                   all vehicles
+ * @return the best matching or first vehicle (depending on find_first).
+ */
+static Vehicle *VehicleFromTileArea(const TileArea &ta, void *data, VehicleFromPosProc *proc, bool find_first)
+{
+	if (ta.w == 0 || ta.h == 0) return NULL;
+
+	int x = TileX(ta.tile);
+	int y = TileY(ta.tile);
+	return VehicleFromTileHash(x, y, x + ta.w - 1, y + ta.h - 1, &ta, data, proc, find_first);
+}
+
+/**
+ * Find a vehicle in a specific area. It will call \a proc for ALL vehicles
+ * on the tiles of the area and YOU must make SURE that the "best one" is
+ * stored in the data value and is ALWAYS the same regardless of the order
+ * of the vehicles where proc was called on!
+ * When you fail to do this properly you create an almost untraceable DESYNC!
+ * @note The return value of \a proc will be ignored.
+ * @param ta   The area on the map.
+ * @param data Arbitrary data passed to \a proc.
+ * @param proc The proc that determines whether a vehicle will be "found".
+ */
+void FindVehicleOnTileArea(const TileArea &ta, void *data, VehicleFromPosProc *proc)
+{
+	VehicleFromTileArea(ta, data, proc, false);
+}
+
+/**
+ * Checks whether a vehicle is in a specific area. It will call \a proc for
+ * vehicles until it returns non-NULL.
+ * @note Use #FindVehicleOnTileArea when you have the intention that all vehicles
+ *       should be iterated over.
+ * @param ta   The area on the map.
+ * @param data Arbitrary data passed to \a proc.
+ * @param proc The proc that determines whether a vehicle will be "found".
+ * @return True if proc returned non-NULL.
+ */
+bool HasVehicleOnTileArea(const TileArea &ta, void *data, VehicleFromPosProc *proc)
+{
+	return VehicleFromTileArea(ta, data, proc, true) != NULL;
+}
+
 /**
  * Callback that returns 'real' vehicles lower or at height \c *(int*)data .
  * @param v Vehicle to examine.
@@ -555,9 +769,7 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	if (remove) {
 		new_hash = NULL;
 	} else {
-		int x = GB(TileX(v->tile), HASH_RES, HASH_BITS);
-		int y = GB(TileY(v->tile), HASH_RES, HASH_BITS) << HASH_BITS;
-		new_hash = &_vehicle_tile_hash[(x + y) & TOTAL_HASH_MASK];
+		new_hash = GetTileHashBucket(TileX(v->tile), TileY(v->tile));
 	}
 
 	if (old_hash == new_hash) return;
@@ -566,10 +778,14 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	if (old_hash != NULL) {
 		if (v->hash_tile_next != NULL) v->hash_tile_next->hash_tile_prev = v->hash_tile_prev;
 		*v->hash_tile_prev = v->hash_tile_next;
+		if (*old_hash == NULL) _vehicle_tile_hash_used--;
+		_vehicle_tile_hash_count--;
 	}
 
 	/* Insert vehicle at beginning of the new position in the hash table */
 	if (new_hash != NULL) {
+		if (*new_hash == NULL) _vehicle_tile_hash_used++;
+		_vehicle_tile_hash_count++;
 		v->hash_tile_next = *new_hash;
 		if (v->hash_tile_next != NULL) v->hash_tile_next->hash_tile_prev = &v->hash_tile_next;
 		v->hash_tile_prev = new_hash;
@@ -580,7 +796,24 @@ static void UpdateVehicleTileHash(Vehicle *v, bool remove)
 	v->hash_tile_current = new_hash;
 }
 
+/* The viewport hash consists of 64x64 cells; the cells are grouped in blocks
+ * of 8x8 cells that count their vehicles, so empty parts of the hash can be
+ * skipped when drawing large areas of the map. */
+static const int VIEWPORT_HASH_BLOCK_BITS = 3;                                 ///< Number of bits of the cell coordinates within a block.
+static const int VIEWPORT_HASH_BLOCK_MASK = (1 << VIEWPORT_HASH_BLOCK_BITS) - 1; ///< Mask of the cell coordinates within a block.
+
 static Vehicle *_vehicle_viewport_hash[0x1000];
+static uint _vehicle_viewport_hash_blocks[0x1000 >> (2 * VIEWPORT_HASH_BLOCK_BITS)]; ///< Number of vehicles per block of the viewport hash.
+
+/**
+ * Get the vehicle count of the block of a cell of the viewport hash.
+ * @param hash The index of the cell in the viewport hash.
+ * @return The vehicle count of the block.
+ */
+static inline uint &GetViewportHashBlock(uint hash)
+{
+	return _vehicle_viewport_hash_blocks[(GB(hash, 6 + VIEWPORT_HASH_BLOCK_BITS, 6 - VIEWPORT_HASH_BLOCK_BITS) << (6 - VIEWPORT_HASH_BLOCK_BITS)) + GB(hash, VIEWPORT_HASH_BLOCK_BITS, 6 - VIEWPORT_HASH_BLOCK_BITS)];
+}
 
 static void UpdateVehicleViewportHash(Vehicle *v, int x, int y)
 {
@@ -597,10 +830,12 @@ static void UpdateVehicleViewportHash(Vehicle *v, int x, int y)
 	if (old_hash != NULL) {
 		if (v->hash_viewport_next != NULL) v->hash_viewport_next->hash_viewport_prev = v->hash_viewport_prev;
 		*v->hash_viewport_prev = v->hash_viewport_next;
+		GetViewportHashBlock(old_hash - _vehicle_viewport_hash)--;
 	}
 
 	/* insert into hash table? */
 	if (new_hash != NULL) {
+		GetViewportHashBlock(new_hash - _vehicle_viewport_hash)++;
 		v->hash_viewport_next = *new_hash;
 		if (v->hash_viewport_next != NULL) v->hash_viewport_next->hash_viewport_prev = &v->hash_viewport_next;
 		v->hash_viewport_prev = new_hash;
@@ -613,7 +848,34 @@ void ResetVehicleHash()
 	Vehicle *v;
 	FOR_ALL_VEHICLES(v) { v->hash_tile_current = NULL; }
 	memset(_vehicle_viewport_hash, 0, sizeof(_vehicle_viewport_hash));
-	memset(_vehicle_tile_hash, 0, sizeof(_vehicle_tile_hash));
+	memset(_vehicle_viewport_hash_blocks, 0, sizeof(_vehicle_viewport_hash_blocks));
+
+	uint bits_x, bits_y;
+	GetTileHashSize(Vehicle::GetNumItems(), &bits_x, &bits_y);
+	ResizeVehicleTileHash(bits_x, bits_y);
+}
+
+/**
+ * Get statistics about the occupancy of the buckets of the tile hash.
+ * @param[out] stats The statistics.
+ */
+void GetVehicleTileHashStats(VehicleTileHashStats *stats)
+{
+	stats->bits_x = _vehicle_tile_hash_bits_x;
+	stats->bits_y = _vehicle_tile_hash_bits_y;
+	stats->vehicles = _vehicle_tile_hash_count;
+	stats->used = _vehicle_tile_hash_used;
+	stats->longest = 0;
+	MemSetT(stats->lengths, 0, lengthof(stats->lengths));
+
+	uint buckets = 1 << (_vehicle_tile_hash_bits_x + _vehicle_tile_hash_bits_y);
+	for (uint i = 0; i < buckets; i++) {
+		uint length = 0;
+		for (const Vehicle *v = _vehicle_tile_hash[i]; v != NULL; v = v->hash_tile_next) length++;
+
+		stats->longest = max(stats->longest, length);
+		stats->lengths[min<uint>(length, lengthof(stats->lengths) - 1)]++;
+	}
 }
 
 void ResetVehicleColourMap()
@@ -632,6 +894,7 @@ static AutoreplaceMap _vehicles_to_autoreplace;
 void InitializeVehicles()
 {
 	_vehicles_to_autoreplace.Reset();
+	for (VehicleType type = VEH_BEGIN; type != VEH_END; type++) _vehicle_tick_lists[type].Reset();
 	ResetVehicleHash();
 }
 
@@ -745,6 +1008,7 @@ void Vehicle::PreDestructor()
 	if (Station::IsValidID(this->last_station_visited)) {
 		Station *st = Station::Get(this->last_station_visited);
 		st->loading_vehicles.remove(this);
+		UpdateLoadingStation(st);
 
 		HideFillingPercent(&this->fill_percent_te_id);
 		this->CancelReservation(INVALID_STATION, st);
@@ -819,6 +1083,7 @@ Vehicle::~Vehicle()
 
 	delete v;
 
+	RemoveFromTickList(this);
 	UpdateVehicleTileHash(this, true);
 	UpdateVehicleViewportHash(this, INVALID_COORD, 0);
 	DeleteVehicleNews(this->index, INVALID_STRING_ID);
@@ -877,25 +1142,34 @@ static void RunVehicleDayProc()
 	}
 }
 
-void CallVehicleTicks()
+/**
+ * Tick the other parts of a vehicle chain, after the first vehicle of the
+ * chain has been ticked, and handle cargo aging and the running sounds of
+ * all parts of the chain.
+ * @param front The first vehicle of the chain.
+ */
+static void TickVehicleChain(Vehicle *front)
 {
-	_vehicles_to_autoreplace.Clear();
-
-	RunVehicleDayProc();
+	for (Vehicle *v = front; v != NULL; v = v->Next()) {
+		if (v != front) {
+			switch (v->type) {
+				case VEH_TRAIN:
+				case VEH_ROAD:
+					/* This is all the tick of a wagon or articulated part does. */
+					v->tick_counter++;
+					break;
 
-	Station *st;
-	FOR_ALL_STATIONS(st) LoadUnloadStation(st);
+				case VEH_DISASTER:
+					/* Shadows and rotors never delete their chain. */
+					v->Tick();
+					break;
 
-	Vehicle *v;
-	FOR_ALL_VEHICLES(v) {
-		/* Vehicle could be deleted in this tick */
-		if (!v->Tick()) {
-			assert(Vehicle::Get(vehicle_index) == NULL);
-			continue;
+				default:
+					/* Shadows and rotors of aircraft are not ticked. */
+					break;
+			}
 		}
 
-		assert(Vehicle::Get(vehicle_index) == v);
-
 		switch (v->type) {
 			default: break;
 
@@ -903,8 +1177,6 @@ void CallVehicleTicks()
 			case VEH_ROAD:
 			case VEH_AIRCRAFT:
 			case VEH_SHIP: {
-				Vehicle *front = v->First();
-
 				if (v->vcache.cached_cargo_age_period != 0) {
 					v->cargo_age_counter = min(v->cargo_age_counter, v->vcache.cached_cargo_age_period);
 					if (--v->cargo_age_counter == 0) {
@@ -955,10 +1227,41 @@ void CallVehicleTicks()
 			}
 		}
 	}
+}
+
+void CallVehicleTicks()
+{
+	_vehicles_to_autoreplace.Clear();
+
+	CheckVehicleTileHashSize();
+
+	RunVehicleDayProc();
+
+	LoadUnloadStations();
+
+	for (VehicleType type = VEH_BEGIN; type != VEH_END; type++) {
+		VehicleTickList &list = _vehicle_tick_lists[type];
+		for (uint i = 0; i < list.Length();) {
+			Vehicle *v = list[i];
+			VehicleID index = v->index;
+
+			/* Vehicle could be deleted in this tick */
+			if (v->Tick()) {
+				assert(Vehicle::Get(index) == v);
+				TickVehicleChain(v);
+			} else {
+				assert(Vehicle::Get(index) == NULL);
+			}
+
+			/* Ticking might have created or deleted vehicles before this one in
+			 * the list; continue with the vehicle that follows it by index. */
+			i = (i < list.Length() && list[i] == v) ? i + 1 : FindTickListPosition(list, index + 1);
+		}
+	}
 
 	Backup<CompanyByte> cur_company(_current_company, FILE_LINE);
 	for (AutoreplaceMap::iterator it = _vehicles_to_autoreplace.Begin(); it != _vehicles_to_autoreplace.End(); it++) {
-		v = it->first;
+		Vehicle *v = it->first;
 		/* Autoreplace needs the current company set as the vehicle owner */
 		cur_company.Change(v->owner);
 
@@ -1029,6 +1332,32 @@ static void DoDrawVehicle(const Vehicle *v)
 		v->x_extent, v->y_extent, v->z_extent, v->z_pos, shadowed, v->x_bb_offs, v->y_bb_offs);
 }
 
+/**
+ * Add the dot of a vehicle to the viewport that is drawn instead of its
+ * sprites. Every visible part of a vehicle chain gets a dot, so a train
+ * stays visible when its front is hidden or off screen. No dots are drawn
+ * for effects, disasters and the shadows of aircraft.
+ * @param v The vehicle to draw.
+ */
+static void AddVehicleDot(const Vehicle *v)
+{
+	switch (v->type) {
+		case VEH_TRAIN:
+		case VEH_ROAD:
+		case VEH_SHIP:
+			break;
+
+		case VEH_AIRCRAFT:
+			if (!Aircraft::From(v)->IsNormalAircraft()) return;
+			break;
+
+		default: return;
+	}
+
+	const Company *c = Company::GetIfValid(v->owner);
+	AddViewportDotToDraw((v->coord.left + v->coord.right) / 2, (v->coord.top + v->coord.bottom) / 2, c == NULL ? COLOUR_WHITE : (Colours)c->colour);
+}
+
 /**
  * Add the vehicle sprites that should be drawn at a part of the screen.
  * @param dpi Rectangle being drawn.
@@ -1062,19 +1391,31 @@ void ViewportAddVehicles(DrawPixelInfo *dpi)
 		yu = 0x3F << 6;
 	}
 
+	/* Far out, vehicles are hardly visible; draw them as dots instead. */
+	bool dots = dpi->zoom >= ZOOM_LVL_VEHICLE_DOTS;
+
 	for (int y = yl;; y = (y + (1 << 6)) & (0x3F << 6)) {
 		for (int x = xl;; x = (x + 1) & 0x3F) {
-			const Vehicle *v = _vehicle_viewport_hash[x + y]; // already masked & 0xFFF
-
-			while (v != NULL) {
-				if (!(v->vehstatus & VS_HIDDEN) &&
-						l <= v->coord.right &&
-						t <= v->coord.bottom &&
-						r >= v->coord.left &&
-						b >= v->coord.top) {
-					DoDrawVehicle(v);
+			if (GetViewportHashBlock(x + y) == 0) {
+				/* Skip the remaining cells of this block in this row */
+				x = (x + min(VIEWPORT_HASH_BLOCK_MASK - (x & VIEWPORT_HASH_BLOCK_MASK), (xu - x) & 0x3F)) & 0x3F;
+			} else {
+				const Vehicle *v = _vehicle_viewport_hash[x + y]; // already masked & 0xFFF
+
+				while (v != NULL) {
+					if (!(v->vehstatus & VS_HIDDEN) &&
+							l <= v->coord.right &&
+							t <= v->coord.bottom &&
+							r >= v->coord.left &&
+							b >= v->coord.top) {
+						if (dots) {
+							AddVehicleDot(v);
+						} else {
+							DoDrawVehicle(v);
+						}
+					}
+					v = v->hash_viewport_next;
 				}
-				v = v->hash_viewport_next;
 			}
 
 			if (x == xu) break;
@@ -2112,6 +2453,7 @@ void Vehicle::LeaveStation()
 	Station *st = Station::Get(this->last_station_visited);
 	this->CancelReservation(INVALID_STATION, st);
 	st->loading_vehicles.remove(this);
+	UpdateLoadingStation(st);
 
 	HideFillingPercent(&this->fill_percent_te_id);
 
@@ -2497,13 +2839,18 @@ void Vehicle::SetNext(Vehicle *next)
 			v->first = this->next;
 		}
 		this->next->previous = NULL;
+		AddToTickList(this->next);
 	}
 
 	this->next = next;
 
 	if (this->next != NULL) {
 		/* A new next vehicle. Update the first and previous pointers */
-		if (this->next->previous != NULL) this->next->previous->next = NULL;
+		if (this->next->previous != NULL) {
+			this->next->previous->next = NULL;
+		} else {
+			RemoveFromTickList(this->next);
+		}
 		this->next->previous = this;
 		for (Vehicle *v = this->next; v != NULL; v = v->Next()) {
 			v->first = this->first;
@@ -21,6 +21,7 @@
 #include "newgrf_config.h"
 #include "track_type.h"
 #include "livery.h"
+#include "tilearea_type.h"
 
 #define is_custom_sprite(x) (x >= 0xFD)
 #define IS_CUSTOM_FIRSTHEAD_SPRITE(x) (x == 0xFD)
@@ -46,6 +47,8 @@ void FindVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc);
 void FindVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc);
 bool HasVehicleOnPos(TileIndex tile, void *data, VehicleFromPosProc *proc);
 bool HasVehicleOnPosXY(int x, int y, void *data, VehicleFromPosProc *proc);
+void FindVehicleOnTileArea(const TileArea &ta, void *data, VehicleFromPosProc *proc);
+bool HasVehicleOnTileArea(const TileArea &ta, void *data, VehicleFromPosProc *proc);
 void CallVehicleTicks();
 uint8 CalcPercentVehicleFilled(const Vehicle *v, StringID *colour);
 
@@ -53,6 +56,19 @@ void VehicleLengthChanged(const Vehicle *u);
 
 byte VehicleRandomBits();
 void ResetVehicleHash();
+
+/** Occupancy of the buckets of the tile hash of the vehicles. */
+struct VehicleTileHashStats {
+	uint bits_x;     ///< Number of bits of the X coordinate used for the hash.
+	uint bits_y;     ///< Number of bits of the Y coordinate used for the hash.
+	uint vehicles;   ///< Number of vehicles in the hash.
+	uint used;       ///< Number of buckets with at least one vehicle.
+	uint longest;    ///< Number of vehicles in the fullest bucket.
+	uint lengths[8]; ///< Number of buckets per number of vehicles in it; the last entry counts all longer buckets too.
+};
+
+void GetVehicleTileHashStats(VehicleTileHashStats *stats);
+void RebuildVehicleTickLists();
 void ResetVehicleColourMap();
 
 byte GetBestFittingSubType(Vehicle *v_from, Vehicle *v_for, CargoID dest_cargo_type);
@@ -79,6 +79,13 @@ struct ChildScreenSpriteToDraw {
 	int next;                       ///< next child to draw (-1 at the end)
 };
 
+/** Dot drawn in place of a vehicle that is too small to draw in detail. */
+struct ViewportDotToDraw {
+	int32 x;                        ///< world X coordinate of the centre of the dot
+	int32 y;                        ///< world Y coordinate of the centre of the dot
+	Colours colour;                 ///< colour of the dot
+};
+
 /** Enumeration of multi-part foundations */
 enum FoundationPart {
 	FOUNDATION_PART_NONE     = 0xFF,  ///< Neither foundation nor groundsprite drawn yet.
@@ -101,6 +108,7 @@ typedef SmallVector<TileSpriteToDraw, 64> TileSpriteToDrawVector;
 typedef SmallVector<StringSpriteToDraw, 4> StringSpriteToDrawVector;
 typedef SmallVector<ParentSpriteToDraw, 64> ParentSpriteToDrawVector;
 typedef SmallVector<ChildScreenSpriteToDraw, 16> ChildScreenSpriteToDrawVector;
+typedef SmallVector<ViewportDotToDraw, 64> ViewportDotToDrawVector;
 
 /** Data structure storing rendering information */
 struct ViewportDrawer {
@@ -111,6 +119,7 @@ struct ViewportDrawer {
 	ParentSpriteToDrawVector parent_sprites_to_draw;
 	ParentSpriteToSortVector parent_sprites_to_sort; ///< Parent sprite pointer array used for sorting
 	ChildScreenSpriteToDrawVector child_screen_sprites_to_draw;
+	ViewportDotToDrawVector dots_to_draw;
 
 	int *last_child;
 
@@ -814,6 +823,21 @@ void AddChildSpriteScreen(SpriteID image, PaletteID pal, int x, int y, bool tran
 	_vd.last_child = &cs->next;
 }
 
+/**
+ * Add a dot to the viewport, drawn on top of all sprites.
+ * Used to draw vehicles at zoom levels where they would be hardly visible.
+ * @param x      X position of the centre of the dot, in world coordinates.
+ * @param y      Y position of the centre of the dot, in world coordinates.
+ * @param colour Colour of the dot.
+ */
+void AddViewportDotToDraw(int x, int y, Colours colour)
+{
+	ViewportDotToDraw *dot = _vd.dots_to_draw.Append();
+	dot->x = x;
+	dot->y = y;
+	dot->colour = colour;
+}
+
 static void AddStringToDraw(int x, int y, StringID string, uint64 params_1, uint64 params_2, Colours colour, uint16 width)
 {
 	assert(width != 0);
@@ -1389,6 +1413,21 @@ static void ViewportDrawDirtyBlocks()
 	} while (--bottom > 0);
 }
 
+/**
+ * Draw the dots added with #AddViewportDotToDraw.
+ * @param zoom The zoom level of the viewport.
+ * @param dots The dots to draw.
+ */
+static void ViewportDrawDots(ZoomLevel zoom, const ViewportDotToDrawVector *dots)
+{
+	const ViewportDotToDraw *end = dots->End();
+	for (const ViewportDotToDraw *dot = dots->Begin(); dot != end; ++dot) {
+		int x = UnScaleByZoom(dot->x, zoom);
+		int y = UnScaleByZoom(dot->y, zoom);
+		GfxFillRect(x - 1, y - 1, x, y, _colour_gradient[dot->colour][6]);
+	}
+}
+
 static void ViewportDrawStrings(ZoomLevel zoom, const StringSpriteToDrawVector *sstdv)
 {
 	const StringSpriteToDraw *ssend = sstdv->End();
@@ -1477,6 +1516,13 @@ void ViewportDoDraw(const ViewPort *vp, int left, int top, int right, int bottom
 	dp.height = UnScaleByZoom(dp.height, zoom);
 	_cur_dpi = &dp;
 
+	if (_vd.dots_to_draw.Length() != 0) {
+		/* translate to world coordinates */
+		dp.left = UnScaleByZoom(_vd.dpi.left, zoom);
+		dp.top = UnScaleByZoom(_vd.dpi.top, zoom);
+		ViewportDrawDots(zoom, &_vd.dots_to_draw);
+	}
+
 	if (vp->overlay != NULL && vp->overlay->GetCargoMask() != 0 && vp->overlay->GetCompanyMask() != 0) {
 		/* translate to window coordinates */
 		dp.left = x;
@@ -1498,6 +1544,7 @@ void ViewportDoDraw(const ViewPort *vp, int left, int top, int right, int bottom
 	_vd.parent_sprites_to_draw.Clear();
 	_vd.parent_sprites_to_sort.Clear();
 	_vd.child_screen_sprites_to_draw.Clear();
+	_vd.dots_to_draw.Clear();
 }
 
 /**